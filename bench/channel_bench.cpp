@@ -0,0 +1,703 @@
+// Microbenchmarks for the message_channel implementations.
+//
+// Measures throughput across batch sizes and producer/consumer counts, and
+// one-way and round-trip latency per wait strategy, using the same sender
+// and receiver drivers as the application, and fan-out latency to many
+// windows with a thread per window versus a strand_pool. Time-to-ready of
+// client launches, one after another versus all at once, and recovery of
+// relogged or crashed clients by the health monitor run against the
+// simulated window system. Results are printed as JSON.
+//
+//   white-clover-bench [--messages N] [--samples N] [--wait MODE] [--quick] [--out FILE]
+
+#include "message_channel.h"
+#include "broadcast_channel.h"
+#include "sender.h"
+#include "receiver.h"
+#include "strand_pool.h"
+#include "launch_pipeline.h"
+#include "window_health_monitor.h"
+#include "simulated_window_system.h"
+#include "logger.h"
+#include "timing.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct bench_options {
+    size_t messages{1000000};
+    size_t latency_samples{20000};
+    uint64_t latency_interval_ns{5000};  // Gap between one-way samples so they don't queue
+    std::vector<wait_mode> wait_modes{wait_mode::busy_spin, wait_mode::spin_yield,
+                                      wait_mode::adaptive, wait_mode::blocking};
+    std::string output;
+};
+
+struct throughput_case {
+    channel_type type;
+    int producers;
+    int consumers;
+    size_t batch_size;
+};
+
+struct throughput_result {
+    throughput_case config;
+    double seconds{0};
+    size_t deliveries{0};
+};
+
+struct latency_summary {
+    size_t samples{0};
+    double mean_ns{0};
+    uint64_t p50_ns{0};
+    uint64_t p99_ns{0};
+    uint64_t p999_ns{0};
+    uint64_t max_ns{0};
+};
+
+struct latency_result {
+    channel_type type;
+    wait_mode wait;
+    latency_summary one_way;
+    latency_summary round_trip;
+};
+
+struct fan_out_result {
+    execution_mode mode;
+    size_t windows;
+    size_t workers;
+    latency_summary delivery;
+};
+
+struct launch_bench_result {
+    bool concurrent;
+    bool scripted;       // Event-driven launch steps instead of the fixed Enter delays
+    size_t clients;
+    int window_sequence;
+    size_t ready{0};
+    double seconds{0};
+};
+
+struct recovery_bench_result {
+    bool crash;          // Process killed and relaunched, otherwise relogged into a new window
+    size_t clients;
+    size_t recovered{0};
+    double seconds{0};   // Fault of every client to the last one re-attached
+};
+
+// Producer and consumer ends of one benchmark channel. For the broadcast
+// ring every consumer has its own reader and the producer publishes to all.
+struct bench_channel {
+    std::shared_ptr<message_channel> producer_side;
+    std::vector<std::shared_ptr<message_channel>> consumer_sides;
+    std::shared_ptr<broadcast_ring> ring;
+    uint64_t all_readers{0};
+
+    bool push_batch(const std::vector<message>& batch) {
+        if (ring) {
+            return ring->publish_batch(batch, all_readers);
+        }
+        return producer_side->try_push_batch(batch);
+    }
+
+    void wake_all() {
+        for (auto& channel : consumer_sides) {
+            channel->wake_all();
+        }
+    }
+};
+
+bench_channel make_bench_channel(channel_type type, int consumers, size_t capacity, const wait_config& wait) {
+    bench_channel result;
+    if (type == channel_type::broadcast_ring) {
+        result.ring = std::make_shared<broadcast_ring>(capacity, wait);
+        for (int i = 0; i < consumers; ++i) {
+            int reader = result.ring->add_reader();
+            result.consumer_sides.push_back(std::make_shared<broadcast_channel>(result.ring, reader));
+            result.all_readers |= uint64_t{1} << reader;
+        }
+        result.producer_side = result.consumer_sides.front();
+        return result;
+    }
+    result.producer_side = make_message_channel(type, capacity, wait);
+    result.consumer_sides.assign(consumers, result.producer_side);
+    return result;
+}
+
+latency_summary summarize(std::vector<uint64_t>& samples) {
+    latency_summary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&](double p) {
+        size_t index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+        return samples[index];
+    };
+    double total = 0;
+    for (uint64_t sample : samples) {
+        total += static_cast<double>(sample);
+    }
+    summary.samples = samples.size();
+    summary.mean_ns = total / static_cast<double>(samples.size());
+    summary.p50_ns = percentile(0.50);
+    summary.p99_ns = percentile(0.99);
+    summary.p999_ns = percentile(0.999);
+    summary.max_ns = samples.back();
+    return summary;
+}
+
+void spin_until(uint64_t deadline_ns) {
+    while (now_ns() < deadline_ns) {
+        cpu_relax();
+    }
+}
+
+throughput_result run_throughput(const throughput_case& config, const bench_options& options) {
+    wait_config wait;
+    wait.mode = options.wait_modes.size() == 1 ? options.wait_modes.front() : wait_mode::adaptive;
+    bench_channel channel = make_bench_channel(config.type, config.consumers,
+                                               message_channel::MAX_QUEUE_SIZE, wait);
+    const bool fan_out = config.type == channel_type::broadcast_ring;
+    const size_t total = options.messages;
+    // Every broadcast reader sees every message, queue consumers share them
+    const size_t expected = fan_out ? total * config.consumers : total;
+
+    std::atomic<bool> running{true};
+    std::atomic<size_t> delivered{0};
+    std::atomic<int> consumers_done{0};
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < config.consumers; ++c) {
+        consumers.emplace_back([&, c]() {
+            receiver msg_receiver(channel.consumer_sides[c], running);
+            size_t own = 0;
+            while (fan_out ? own < total : delivered.load(std::memory_order_relaxed) < total) {
+                auto batch = msg_receiver.receive_batch(config.batch_size);
+                if (batch.empty()) {
+                    break;
+                }
+                own += batch.size();
+                delivered.fetch_add(batch.size(), std::memory_order_relaxed);
+            }
+            if (consumers_done.fetch_add(1) + 1 == config.consumers ||
+                delivered.load() >= expected) {
+                running = false;
+                channel.wake_all();
+            }
+        });
+    }
+
+    auto start = now_ns();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < config.producers; ++p) {
+        size_t quota = total / config.producers + (static_cast<size_t>(p) < total % config.producers ? 1 : 0);
+        producers.emplace_back([&, quota]() {
+            sender msg_sender(channel.producer_side, running);
+            std::vector<message> batch;
+            batch.reserve(config.batch_size);
+            size_t sent = 0;
+            while (sent < quota) {
+                batch.clear();
+                for (size_t i = 0; i < config.batch_size && sent + i < quota; ++i) {
+                    batch.emplace_back(message_command::text, static_cast<uint32_t>(sent + i));
+                }
+                bool pushed = fan_out ? channel.push_batch(batch) : msg_sender.send_batch(batch);
+                while (!pushed) {
+                    cpu_relax();
+                    pushed = fan_out ? channel.push_batch(batch) : msg_sender.send_batch(batch);
+                }
+                sent += batch.size();
+            }
+        });
+    }
+
+    for (auto& t : producers) {
+        t.join();
+    }
+    for (auto& t : consumers) {
+        t.join();
+    }
+    auto end = now_ns();
+
+    throughput_result result;
+    result.config = config;
+    result.seconds = static_cast<double>(end - start) / 1e9;
+    result.deliveries = delivered.load();
+    return result;
+}
+
+latency_summary run_one_way(channel_type type, const wait_config& wait, const bench_options& options) {
+    bench_channel channel = make_bench_channel(type, 1, message_channel::MAX_QUEUE_SIZE, wait);
+    std::atomic<bool> running{true};
+    std::vector<uint64_t> samples;
+    samples.reserve(options.latency_samples);
+
+    std::thread consumer([&]() {
+        receiver msg_receiver(channel.consumer_sides.front(), running);
+        while (samples.size() < options.latency_samples) {
+            auto msg = msg_receiver.receive_message();
+            if (!msg) {
+                break;
+            }
+            samples.push_back(now_ns() - msg->timestamp_ns);
+        }
+    });
+
+    sender msg_sender(channel.producer_side, running);
+    uint64_t next_send = now_ns();
+    for (size_t i = 0; i < options.latency_samples; ++i) {
+        spin_until(next_send);
+        message msg(message_command::text, static_cast<uint32_t>(i));
+        msg.timestamp_ns = now_ns();
+        while (!msg_sender.send_message(msg)) {
+            cpu_relax();
+        }
+        next_send = msg.timestamp_ns + options.latency_interval_ns;
+    }
+
+    consumer.join();
+    return summarize(samples);
+}
+
+latency_summary run_round_trip(channel_type type, const wait_config& wait, const bench_options& options) {
+    bench_channel ping = make_bench_channel(type, 1, message_channel::MAX_QUEUE_SIZE, wait);
+    bench_channel pong = make_bench_channel(type, 1, message_channel::MAX_QUEUE_SIZE, wait);
+    std::atomic<bool> running{true};
+
+    std::thread echo([&]() {
+        receiver msg_receiver(ping.consumer_sides.front(), running);
+        sender msg_sender(pong.producer_side, running);
+        for (size_t i = 0; i < options.latency_samples; ++i) {
+            auto msg = msg_receiver.receive_message();
+            if (!msg) {
+                break;
+            }
+            while (!msg_sender.send_message(*msg)) {
+                cpu_relax();
+            }
+        }
+    });
+
+    std::vector<uint64_t> samples;
+    samples.reserve(options.latency_samples);
+    sender msg_sender(ping.producer_side, running);
+    receiver msg_receiver(pong.consumer_sides.front(), running);
+    for (size_t i = 0; i < options.latency_samples; ++i) {
+        message msg(message_command::text, static_cast<uint32_t>(i));
+        msg.timestamp_ns = now_ns();
+        while (!msg_sender.send_message(msg)) {
+            cpu_relax();
+        }
+        auto reply = msg_receiver.receive_message();
+        if (!reply) {
+            break;
+        }
+        samples.push_back(now_ns() - reply->timestamp_ns);
+    }
+
+    echo.join();
+    return summarize(samples);
+}
+
+// One producer sends a message to each of many spsc channels per round, the
+// way the key monitor fans out to input senders, and the consumers record
+// publish-to-receive latency. Consumers are either a parked thread each or
+// strands on a pool.
+fan_out_result run_fan_out(execution_mode mode, size_t windows, size_t workers, const bench_options& options) {
+    wait_config wait;
+    wait.mode = wait_mode::blocking;
+    std::vector<std::shared_ptr<message_channel>> channels;
+    std::vector<std::vector<uint64_t>> samples(windows);
+    for (size_t i = 0; i < windows; ++i) {
+        channels.push_back(make_message_channel(channel_type::spsc_ring, message_channel::MAX_QUEUE_SIZE, wait));
+    }
+    size_t rounds = std::max<size_t>(1, options.latency_samples / windows);
+    std::atomic<bool> running{true};
+    std::atomic<size_t> done{0};
+
+    auto consume = [&](size_t window) {
+        message msg;
+        while (channels[window]->try_pop(msg)) {
+            samples[window].push_back(now_ns() - msg.timestamp_ns);
+            if (samples[window].size() == rounds) {
+                done.fetch_add(1);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    strand_pool pool(workers);
+    if (mode == execution_mode::pool) {
+        for (size_t i = 0; i < windows; ++i) {
+            strand* s = pool.add_strand([&consume, i]() {
+                consume(i);
+                return NO_DEADLINE;
+            });
+            channels[i]->set_wakeup_listener(s);
+        }
+        pool.start();
+    } else {
+        for (size_t i = 0; i < windows; ++i) {
+            threads.emplace_back([&, i]() {
+                while (running) {
+                    consume(i);
+                    channels[i]->wait_for_messages(running);
+                }
+            });
+        }
+    }
+
+    uint64_t next_send = now_ns();
+    for (size_t round = 0; round < rounds; ++round) {
+        spin_until(next_send);
+        for (size_t i = 0; i < windows; ++i) {
+            message msg(message_command::text, static_cast<uint32_t>(round));
+            msg.timestamp_ns = now_ns();
+            while (!channels[i]->try_push(msg)) {
+                cpu_relax();
+            }
+        }
+        next_send = now_ns() + options.latency_interval_ns * 10;
+    }
+    while (done.load() < windows) {
+        std::this_thread::yield();
+    }
+
+    running = false;
+    for (auto& channel : channels) {
+        channel->set_wakeup_listener(nullptr);
+        channel->wake_all();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    pool.stop();
+
+    std::vector<uint64_t> all;
+    for (auto& window : samples) {
+        all.insert(all.end(), window.begin(), window.end());
+    }
+    return {mode, windows, mode == execution_mode::pool ? pool.worker_count() : windows, summarize(all)};
+}
+
+// Launches clients that each show a launcher, a login screen and the game
+// window, either one at a time like the old ProcessManager or all at once,
+// with the default script or one that presses Enter as soon as each
+// window is up.
+launch_bench_result run_launch(bool concurrent, bool scripted, size_t clients) {
+    simulated_program program;
+    program.titles = {"Launcher", "Login", "Anarchy Online"};
+    program.startup_ns = 30'000'000;
+    program.step_ns = 20'000'000;
+    simulated_window_system windows;
+    windows.add_program("Anarchy.exe", program);
+    windows.start();
+
+    std::vector<launch_step> steps;
+    if (scripted) {
+        for (size_t i = 0; i < program.titles.size(); ++i) {
+            launch_step wait;
+            wait.pattern = program.titles[i];
+            wait.match = title_match_mode::exact;
+            steps.push_back(wait);
+            if (i + 1 < program.titles.size()) {
+                launch_step enter;
+                enter.type = launch_step_type::send_keys;
+                enter.keys = {0x0D};
+                steps.push_back(enter);
+            }
+        }
+    }
+
+    std::vector<launch_spec> specs;
+    for (size_t i = 0; i < clients; ++i) {
+        specs.push_back(launch_spec{"client" + std::to_string(i), 0, "Anarchy.exe", {},
+                                    static_cast<int>(program.titles.size()), steps});
+    }
+
+    launch_bench_result result{concurrent, scripted, clients, static_cast<int>(program.titles.size())};
+    window_registry registry(windows);
+    launch_pipeline pipeline(windows, registry);
+    uint64_t start = now_ns();
+    std::vector<launch_result> launched;
+    if (concurrent) {
+        launched = pipeline.run(specs);
+    } else {
+        for (const auto& spec : specs) {
+            auto one = pipeline.run({spec});
+            launched.insert(launched.end(), one.begin(), one.end());
+        }
+    }
+    result.seconds = (now_ns() - start) / 1e9;
+    for (const auto& r : launched) {
+        result.ready += r.state == launch_state::ready ? 1 : 0;
+    }
+    windows.stop();
+    return result;
+}
+
+// Every attached client faults at once: a relog closes the game window and
+// opens a new one, a crash kills the process so the monitor relaunches it
+recovery_bench_result run_recovery(bool crash, size_t clients) {
+    simulated_program program;
+    program.titles = {"Launcher", "Login", "Anarchy Online"};
+    program.startup_ns = 30'000'000;
+    program.step_ns = 20'000'000;
+    simulated_window_system windows;
+    title_matcher matcher;
+    std::vector<launch_spec> specs;
+    for (size_t i = 0; i < clients; ++i) {
+        std::string id = "client" + std::to_string(i);
+        simulated_program own = program;
+        own.titles.back() += " - " + id;
+        windows.add_program(id + ".exe", own);
+        matcher.add(id, title_match_mode::contains, static_cast<int>(i));
+        specs.push_back(launch_spec{id, 0, id + ".exe", {}, static_cast<int>(own.titles.size()), {}});
+    }
+    matcher.compile();
+
+    recovery_bench_result result{crash, clients};
+    window_registry registry(windows);
+    windows.start();
+    std::vector<launch_result> launched = launch_pipeline(windows, registry).run(specs);
+    windows.stop();
+
+    health_config config;
+    config.sweep_interval_ms = 100;
+    config.rematch_grace_ms = 50;
+    window_health_monitor monitor(windows, registry, matcher, config);
+    for (size_t i = 0; i < clients; ++i) {
+        registry.attach(window_key{specs[i].id, 0}, launched[i].window);
+        monitor.add_client(monitored_client{specs[i], static_cast<int>(i), true});
+    }
+    std::atomic<size_t> recovered{0};
+    monitor.set_handler([&](const monitored_client&, window_handle, const launched_process&) {
+        recovered.fetch_add(1);
+    });
+    monitor.start();
+
+    uint64_t start = now_ns();
+    for (size_t i = 0; i < clients; ++i) {
+        if (crash) {
+            windows.crash(launched[i].process.pid);
+        } else {
+            windows.destroy_window(launched[i].window);
+            windows.create_window(launched[i].process.pid, launched[i].title);
+        }
+    }
+    uint64_t give_up = start + 30'000'000'000;
+    while (recovered.load() < clients && now_ns() < give_up) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    result.seconds = (now_ns() - start) / 1e9;
+    result.recovered = recovered.load();
+    monitor.stop();
+    return result;
+}
+
+std::vector<throughput_case> throughput_cases() {
+    std::vector<throughput_case> cases;
+    for (size_t batch : {size_t{1}, size_t{16}, size_t{256}}) {
+        cases.push_back({channel_type::mutex_queue, 1, 1, batch});
+        cases.push_back({channel_type::mutex_queue, 4, 1, batch});
+        cases.push_back({channel_type::mutex_queue, 1, 4, batch});
+        cases.push_back({channel_type::mutex_queue, 4, 4, batch});
+        cases.push_back({channel_type::spsc_ring, 1, 1, batch});
+        cases.push_back({channel_type::broadcast_ring, 1, 1, batch});
+        cases.push_back({channel_type::broadcast_ring, 1, 4, batch});
+    }
+    return cases;
+}
+
+void write_summary(std::ostream& out, const char* name, const latency_summary& summary) {
+    out << "\"" << name << "\": {"
+        << "\"samples\": " << summary.samples
+        << ", \"mean_ns\": " << summary.mean_ns
+        << ", \"p50_ns\": " << summary.p50_ns
+        << ", \"p99_ns\": " << summary.p99_ns
+        << ", \"p999_ns\": " << summary.p999_ns
+        << ", \"max_ns\": " << summary.max_ns << "}";
+}
+
+void write_json(std::ostream& out, const bench_options& options,
+                const std::vector<throughput_result>& throughput,
+                const std::vector<latency_result>& latency,
+                const std::vector<fan_out_result>& fan_out,
+                const std::vector<launch_bench_result>& launch,
+                const std::vector<recovery_bench_result>& recovery) {
+    out << "{\n";
+    out << "  \"benchmark\": \"white-clover-channels\",\n";
+    out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"messages\": " << options.messages << ",\n";
+    out << "  \"throughput\": [\n";
+    for (size_t i = 0; i < throughput.size(); ++i) {
+        const auto& r = throughput[i];
+        out << "    {\"channel\": \"" << channel_type_name(r.config.type) << "\""
+            << ", \"producers\": " << r.config.producers
+            << ", \"consumers\": " << r.config.consumers
+            << ", \"batch_size\": " << r.config.batch_size
+            << ", \"seconds\": " << r.seconds
+            << ", \"deliveries\": " << r.deliveries
+            << ", \"deliveries_per_second\": " << static_cast<double>(r.deliveries) / r.seconds
+            << "}" << (i + 1 < throughput.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"latency\": [\n";
+    for (size_t i = 0; i < latency.size(); ++i) {
+        const auto& r = latency[i];
+        out << "    {\"channel\": \"" << channel_type_name(r.type) << "\""
+            << ", \"wait\": \"" << wait_mode_name(r.wait) << "\", ";
+        write_summary(out, "one_way", r.one_way);
+        out << ", ";
+        write_summary(out, "round_trip", r.round_trip);
+        out << "}" << (i + 1 < latency.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"fan_out\": [\n";
+    for (size_t i = 0; i < fan_out.size(); ++i) {
+        const auto& r = fan_out[i];
+        out << "    {\"execution\": \"" << execution_mode_name(r.mode) << "\""
+            << ", \"windows\": " << r.windows
+            << ", \"threads\": " << r.workers << ", ";
+        write_summary(out, "delivery", r.delivery);
+        out << "}" << (i + 1 < fan_out.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"launch\": [\n";
+    for (size_t i = 0; i < launch.size(); ++i) {
+        const auto& r = launch[i];
+        out << "    {\"mode\": \"" << (r.concurrent ? "concurrent" : "sequential") << "\""
+            << ", \"script\": \"" << (r.scripted ? "event_driven" : "fixed_delays") << "\""
+            << ", \"clients\": " << r.clients
+            << ", \"window_sequence\": " << r.window_sequence
+            << ", \"ready\": " << r.ready
+            << ", \"seconds\": " << r.seconds
+            << "}" << (i + 1 < launch.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"recovery\": [\n";
+    for (size_t i = 0; i < recovery.size(); ++i) {
+        const auto& r = recovery[i];
+        out << "    {\"fault\": \"" << (r.crash ? "crash" : "relog") << "\""
+            << ", \"clients\": " << r.clients
+            << ", \"recovered\": " << r.recovered
+            << ", \"seconds\": " << r.seconds
+            << "}" << (i + 1 < recovery.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+bool parse_args(int argc, char** argv, bench_options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        if (arg == "--messages") {
+            const char* value = next();
+            if (!value) return false;
+            options.messages = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--samples") {
+            const char* value = next();
+            if (!value) return false;
+            options.latency_samples = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--wait") {
+            const char* value = next();
+            wait_mode mode;
+            if (!value || !parse_wait_mode(value, mode)) return false;
+            options.wait_modes = {mode};
+        } else if (arg == "--quick") {
+            options.messages = 100000;
+            options.latency_samples = 2000;
+        } else if (arg == "--out") {
+            const char* value = next();
+            if (!value) return false;
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    return options.messages > 0 && options.latency_samples > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    bench_options options;
+    if (!parse_args(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--messages N] [--samples N] [--wait busy_spin|spin_yield|adaptive|blocking]"
+                  << " [--quick] [--out FILE]\n";
+        return 1;
+    }
+    // Results go to stdout, so the log shares stderr with the progress lines
+    logger::get_instance().set_output(std::cerr);
+    logger::get_instance().set_level(log_level::warn);
+    logger::get_instance().start();
+
+    std::vector<throughput_result> throughput;
+    for (const auto& config : throughput_cases()) {
+        std::cerr << "throughput: " << channel_type_name(config.type)
+                  << " " << config.producers << "p/" << config.consumers << "c"
+                  << " batch " << config.batch_size << "\n";
+        throughput.push_back(run_throughput(config, options));
+    }
+
+    std::vector<latency_result> latency;
+    for (channel_type type : {channel_type::mutex_queue, channel_type::spsc_ring, channel_type::broadcast_ring}) {
+        for (wait_mode mode : options.wait_modes) {
+            std::cerr << "latency: " << channel_type_name(type) << " " << wait_mode_name(mode) << "\n";
+            wait_config wait;
+            wait.mode = mode;
+            latency_result result;
+            result.type = type;
+            result.wait = mode;
+            result.one_way = run_one_way(type, wait, options);
+            result.round_trip = run_round_trip(type, wait, options);
+            latency.push_back(result);
+        }
+    }
+
+    std::vector<fan_out_result> fan_out;
+    for (size_t windows : {size_t{8}, size_t{48}}) {
+        std::cerr << "fan-out: " << windows << " windows\n";
+        fan_out.push_back(run_fan_out(execution_mode::threads, windows, 0, options));
+        fan_out.push_back(run_fan_out(execution_mode::pool, windows, 4, options));
+    }
+
+    std::vector<launch_bench_result> launch;
+    for (bool concurrent : {false, true}) {
+        std::cerr << "launch: " << (concurrent ? "concurrent" : "sequential") << "\n";
+        launch.push_back(run_launch(concurrent, false, 5));
+    }
+    std::cerr << "launch: concurrent, event-driven steps\n";
+    launch.push_back(run_launch(true, true, 5));
+
+    std::vector<recovery_bench_result> recovery;
+    for (bool crash : {false, true}) {
+        std::cerr << "recovery: " << (crash ? "crash" : "relog") << "\n";
+        recovery.push_back(run_recovery(crash, 5));
+    }
+
+    if (options.output.empty()) {
+        write_json(std::cout, options, throughput, latency, fan_out, launch, recovery);
+    } else {
+        std::ofstream file(options.output);
+        if (!file) {
+            std::cerr << "Failed to open " << options.output << "\n";
+            return 1;
+        }
+        write_json(file, options, throughput, latency, fan_out, launch, recovery);
+    }
+    logger::get_instance().stop();
+    return 0;
+}
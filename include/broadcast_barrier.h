@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "latency_histogram.h"
+#include "platform_hints.h"
+
+// Rendezvous points for synchronous broadcasts. The key monitor opens a
+// barrier for every moment of a synchronous binding and stamps its token
+// into the messages. Each input sender arrives, spins until every window
+// has arrived or the deadline passes, injects and reports when it did. The
+// spread of those times is the skew between the first and last window.
+class broadcast_barrier {
+public:
+    static constexpr int SLOTS = 64;
+
+    static broadcast_barrier& get_instance() {
+        static broadcast_barrier instance;
+        return instance;
+    }
+
+    // Key monitor side. open() fails when every slot is in use.
+    bool open(uint32_t windows, uint64_t deadline_ns, uint16_t& token);
+    void withdraw(uint16_t token, uint32_t windows);  // Windows the moment never reached
+
+    // Input sender side, once per window and token
+    bool arrive_and_wait(uint16_t token);             // False when it gave up at the deadline
+    void finish(uint16_t token, uint64_t injected_ns);
+    void skip(uint16_t token);                        // Arrives and finishes without injecting
+
+    uint64_t timeouts() const { return timeout_count.load(std::memory_order_relaxed); }
+    void print_metrics() const;
+
+private:
+    static constexpr int SLOT_BITS = 6;
+    static constexpr uint16_t GENERATION_MASK = 0xFFFF >> SLOT_BITS;
+    static constexpr int SPIN_ITERATIONS = 4096;         // Before waiters start yielding
+    static constexpr uint64_t STALE_NS = 1'000'000'000;  // Slots nobody finished are reclaimed after this
+
+    // Fields of slot::state, 16 bits each. Every update checks the
+    // generation in the same compare-exchange, so a sender holding the token
+    // of a reclaimed moment can never count towards the next one.
+    static constexpr int GENERATION_SHIFT = 48;
+    static constexpr int WINDOWS_SHIFT = 32;
+    static constexpr int ARRIVED_SHIFT = 16;
+    static constexpr uint64_t FIELD_MASK = 0xFFFF;
+
+    struct alignas(CACHE_LINE_SIZE) slot {
+        std::atomic<bool> busy{false};
+        std::atomic<uint64_t> state{0};       // Generation, windows, arrived, finished
+        std::atomic<uint32_t> injected{0};
+        std::atomic<uint64_t> first_ns{0};
+        std::atomic<uint64_t> last_ns{0};
+        std::atomic<uint64_t> deadline_ns{0};
+    };
+
+    broadcast_barrier() = default;
+    broadcast_barrier(const broadcast_barrier&) = delete;
+    broadcast_barrier& operator=(const broadcast_barrier&) = delete;
+
+    static uint64_t field(uint64_t state, int shift) { return (state >> shift) & FIELD_MASK; }
+    static bool complete(uint64_t state) { return field(state, 0) >= field(state, WINDOWS_SHIFT); }
+    // Applies change to the state of the token's moment, false when the
+    // slot was reclaimed or the moment is already complete
+    template <typename Change>
+    bool update(uint16_t token, Change change);
+
+    slot slots[SLOTS];
+    latency_histogram skew;
+    std::atomic<uint64_t> timeout_count{0};
+    std::atomic<uint64_t> exhausted_count{0};
+};
@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "message_channel.h"
+#include "platform_hints.h"
+
+// Single-writer, multi-reader ring in the style of a disruptor. Every entry
+// carries a bitmask of the readers it is addressed to; each reader keeps its
+// own cursor and skips entries without its bit. One publish reaches any
+// number of input senders and only the addressed readers are woken. When
+// the ring fills up, the writer moves readers with nothing addressed to them
+// past the entries they would only skip, so an idle reader never holds the
+// ring; readers commit their cursors with a CAS and retry when moved. A
+// reader announces where its scan starts, and the writer never overwrites
+// entries from there on until the scan ends.
+class broadcast_ring {
+public:
+    static constexpr int MAX_READERS = 64;
+
+    explicit broadcast_ring(size_t capacity = message_channel::MAX_QUEUE_SIZE,
+                            const wait_config& wait = wait_config{});
+
+    int add_reader();  // Returns the reader index, or -1 when all slots are taken
+    // The reader no longer holds the ring and its index may be reused.
+    // Like add_reader(), only while nothing publishes or reads with it.
+    void remove_reader(int reader);
+    bool publish(const message& msg, uint64_t target_mask);
+    bool publish_batch(const std::vector<message>& messages, uint64_t target_mask);
+    // publish() under the ring's overflow policy. The policy and counters
+    // are shared by every reader; drop_oldest degrades to drop_newest since
+    // only readers move their cursors.
+    bool push(const message& msg, uint64_t target_mask);
+    void set_overflow(const overflow_config& config) { overflow.configure(config); }
+    overflow_stats get_overflow_stats() const { return overflow.stats(); }
+
+    bool try_read(int reader, message& msg);
+    size_t try_read_batch(int reader, std::vector<message>& out, size_t max_messages);
+    void wait(int reader, const std::atomic<bool>& running);
+    bool wait_until(int reader, const std::atomic<bool>& running, uint64_t deadline_ns);
+    void wake_all();
+    void set_listener(int reader, wakeup_listener* listener) { readers[reader]->waiter.set_listener(listener); }
+
+    size_t pending(int reader) const;
+    size_t capacity() const { return mask + 1; }
+    wait_stats get_wait_stats(int reader) const { return readers[reader]->waiter.stats(); }
+
+private:
+    static constexpr uint64_t NOT_SCANNING = UINT64_MAX;
+
+    struct entry {
+        message msg;
+        std::atomic<uint64_t> target_mask{0};
+    };
+
+    struct alignas(CACHE_LINE_SIZE) reader_slot {
+        explicit reader_slot(const wait_config& wait) : waiter(wait) {}
+        std::atomic<uint64_t> cursor{0};
+        std::atomic<uint64_t> scan{NOT_SCANNING};  // First entry the reader may be reading
+        std::atomic<bool> active{false};
+        wait_strategy waiter;
+    };
+
+    bool reserve(uint64_t seq, size_t count);
+    bool newest_pending(const message& msg, uint64_t target_mask) const;
+    void record_fill(uint64_t seq);
+    void notify_readers(uint64_t target_mask);
+    void mark_addressed(uint64_t target_mask, uint64_t end);
+    void advance_idle_readers(uint64_t seq);
+    bool skip_to_addressed(int reader);
+    static uint64_t begin_scan(reader_slot& slot);
+    static void end_scan(reader_slot& slot) { slot.scan.store(NOT_SCANNING, std::memory_order_release); }
+    void write_entry(uint64_t seq, const message& msg, uint64_t target_mask);
+    uint64_t min_reader_cursor(uint64_t seq) const;
+
+    size_t mask;
+    std::unique_ptr<entry[]> entries;
+    std::vector<std::unique_ptr<reader_slot>> readers;
+    std::atomic<int> reader_count{0};
+
+    // Writer-owned line
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> published{0};
+    uint64_t cached_min_cursor{0};
+    uint64_t addressed_end[MAX_READERS]{};  // One past the last entry addressed to each reader
+    overflow_guard overflow;
+};
+
+// message_channel view of one reader of a broadcast_ring. Pushing through the
+// view publishes to this reader only; fan-out goes through ring().publish().
+class broadcast_channel : public message_channel {
+public:
+    broadcast_channel(std::shared_ptr<broadcast_ring> ring, int reader);
+    ~broadcast_channel() override;
+
+    bool try_push(const message& msg) override;
+    bool try_push_batch(const std::vector<message>& messages) override;
+    bool try_pop(message& msg) override;
+    size_t try_pop_batch(std::vector<message>& out, size_t max_messages) override;
+    void wait_for_messages(const std::atomic<bool>& running) override;
+    bool wait_for_messages_until(const std::atomic<bool>& running, uint64_t deadline_ns) override;
+    void wake_all() override;
+    void set_wakeup_listener(wakeup_listener* listener) override { shared_ring->set_listener(reader, listener); }
+    size_t size() const override;
+    size_t capacity() const override { return shared_ring->capacity(); }
+    const char* type_name() const override { return "broadcast"; }
+    wait_stats get_wait_stats() const override { return shared_ring->get_wait_stats(reader); }
+    bool push(const message& msg) override { return shared_ring->push(msg, reader_mask()); }
+    void set_overflow(const overflow_config& config) override { shared_ring->set_overflow(config); }
+    overflow_stats get_overflow_stats() const override { return shared_ring->get_overflow_stats(); }
+
+    broadcast_ring& ring() { return *shared_ring; }
+    uint64_t reader_mask() const { return uint64_t{1} << reader; }
+
+private:
+    std::shared_ptr<broadcast_ring> shared_ring;
+    int reader;
+};
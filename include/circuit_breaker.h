@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+enum class breaker_state {
+    closed,     // Healthy, keys are injected
+    open,       // Tripped, keys are dropped or parked until the next probe
+    half_open   // A probe is in flight
+};
+
+enum class open_policy {
+    drop,  // Discard messages while the window is unhealthy
+    park   // Leave them in the channel and deliver them after recovery
+};
+
+struct breaker_config {
+    uint32_t timeout_ms{100};          // Longest one injection call may block
+    uint32_t failure_threshold{2};     // Consecutive failed injections that trip the breaker
+    uint32_t probe_interval_ms{1000};  // First wait before probing a tripped window
+    uint32_t max_probe_interval_ms{8000};
+    open_policy policy{open_policy::drop};
+};
+
+// Health of one target window. Updated only by the owning input sender,
+// read from anywhere for metrics. Failed probes double the wait before the
+// next one, up to max_probe_interval_ms.
+class circuit_breaker {
+public:
+    explicit circuit_breaker(const breaker_config& config = breaker_config{});
+
+    bool closed() const { return current() == breaker_state::closed; }
+    breaker_state current() const { return state.load(std::memory_order_relaxed); }
+    const breaker_config& config() const { return cfg; }
+
+    void record_success();
+    bool record_failure(uint64_t now_ns);  // True when this failure tripped the breaker
+
+    bool probe_due(uint64_t now_ns) const;
+    uint64_t next_probe_ns() const;        // NO_DEADLINE unless open
+    void begin_probe();
+
+    uint64_t trips() const { return trip_count.load(std::memory_order_relaxed); }
+    uint64_t probes() const { return probe_count.load(std::memory_order_relaxed); }
+    uint64_t recoveries() const { return recovery_count.load(std::memory_order_relaxed); }
+
+private:
+    void open_at(uint64_t now_ns);
+
+    breaker_config cfg;
+    std::atomic<breaker_state> state{breaker_state::closed};
+    uint32_t consecutive_failures{0};
+    uint64_t probe_interval_ns;
+    uint64_t probe_at_ns{0};
+
+    std::atomic<uint64_t> trip_count{0};
+    std::atomic<uint64_t> probe_count{0};
+    std::atomic<uint64_t> recovery_count{0};
+};
+
+const char* breaker_state_name(breaker_state state);
+bool parse_open_policy(const std::string& name, open_policy& policy);
+const char* open_policy_name(open_policy policy);
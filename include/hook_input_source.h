@@ -0,0 +1,34 @@
+#pragma once
+#include <Windows.h>
+#include <atomic>
+#include <future>
+#include <thread>
+#include "i_input_source.h"
+#include "input_event_queue.h"
+
+// Event-driven source backed by a WH_KEYBOARD_LL hook. The hook lives on a
+// dedicated message-loop thread and hands each transition to the consumer
+// through an input_event_queue, so detection costs no polling at all.
+// Only one instance can be active at a time.
+class hook_input_source : public i_input_source {
+public:
+    hook_input_source() = default;
+    ~hook_input_source() override;
+
+    bool start() override;
+    void stop() override;
+    bool next_event(input_event& event, uint64_t deadline_ns) override {
+        return queue.pop(event, deadline_ns);
+    }
+    const char* name() const override { return "hook"; }
+
+private:
+    static LRESULT CALLBACK hook_proc(int code, WPARAM wparam, LPARAM lparam);
+    void run(std::promise<bool> installed);
+
+    input_event_queue queue;
+    std::thread hook_thread;
+    std::atomic<DWORD> hook_thread_id{0};
+
+    static std::atomic<hook_input_source*> active;
+};
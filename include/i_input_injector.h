@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Native window handle (HWND on Windows), opaque outside the platform code
+using window_handle = void*;
+
+enum class injector_type {
+    send_message,  // Synchronous SendMessage, blocks until the window handles the key
+    post_message,  // Queued PostMessage, returns immediately
+    send_input,    // SendInput into the foreground window, the closest to real typing
+    recording      // Records keys in memory, no window involved
+};
+
+enum class inject_error {
+    none,
+    timeout,   // The window did not handle the key in time, it may be hung
+    rejected   // The call failed outright, e.g. a full message queue
+};
+
+struct key_transition {
+    uint16_t vk_code;
+    uint16_t scan_code;
+    bool extended;
+    bool down;
+};
+
+// Delivers key transitions to a target window
+class i_input_injector {
+public:
+    virtual ~i_input_injector() = default;
+    virtual bool key_down(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) = 0;
+    virtual bool key_up(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) = 0;
+    virtual const char* name() const = 0;
+
+    // Cheap check that the window still answers, used to test a window whose
+    // circuit breaker tripped
+    virtual bool probe(window_handle window) { (void)window; return true; }
+
+    // Longest a single call may block on the window, 0 waits for as long as it takes
+    void set_timeout(uint32_t timeout_ms) { call_timeout_ms = timeout_ms; }
+    uint32_t timeout() const { return call_timeout_ms; }
+    // Why the last failed delivery failed
+    inject_error last_error() const { return error; }
+
+    // Delivers a run of transitions in order, stopping at the first failure.
+    // Returns how many were delivered. Backends override it when they can
+    // hand over the whole run in one call.
+    virtual size_t inject(window_handle window, const key_transition* keys, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const key_transition& key = keys[i];
+            bool delivered = key.down ? key_down(window, key.vk_code, key.scan_code, key.extended)
+                                      : key_up(window, key.vk_code, key.scan_code, key.extended);
+            if (!delivered) {
+                return i;
+            }
+        }
+        return count;
+    }
+
+protected:
+    uint32_t call_timeout_ms{0};
+    inject_error error{inject_error::none};
+};
+
+bool parse_injector_type(const std::string& name, injector_type& type);
+const char* injector_type_name(injector_type type);
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// One physical key transition, stamped when the source first saw it
+struct input_event {
+    uint16_t vk_code{0};
+    uint16_t scan_code{0};
+    bool key_down{false};
+    bool extended{false};
+    uint64_t timestamp_ns{0};
+};
+
+enum class input_source_type {
+    hook,    // Low-level keyboard hook, events delivered as they happen
+    poll,    // GetAsyncKeyState scan, fallback when the hook cannot be installed
+    replay   // Events read from a file, available on every platform
+};
+
+class i_input_source {
+public:
+    virtual ~i_input_source() = default;
+    virtual bool start() = 0;
+    virtual void stop() = 0;  // Also releases a thread blocked in next_event()
+    // Blocks until an event is available or deadline_ns (a now_ns() timestamp)
+    // passes. Returns false on timeout or once the source is stopped.
+    virtual bool next_event(input_event& event, uint64_t deadline_ns) = 0;
+    virtual const char* name() const = 0;
+};
+
+bool parse_input_source_type(const std::string& name, input_source_type& type);
+const char* input_source_type_name(input_source_type type);
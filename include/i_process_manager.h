@@ -1,11 +1,18 @@
 #pragma once
 #include <Windows.h>
+#include <functional>
 #include <string>
 
+// Called when a client's window was replaced while running
+using window_replaced_listener = std::function<void(const std::string& process_id, int instance, HWND window)>;
+
 class i_process_manager {
 public:
     virtual ~i_process_manager() = default;
     virtual bool launch_processes() = 0;
     virtual HWND get_window_handle(const std::string& process_id, int instance = 0) const = 0;
     virtual void terminate_processes() = 0;
+    // Watches the attached windows and recovers crashed or relogged clients
+    virtual bool start_health_monitor(window_replaced_listener listener) = 0;
+    virtual void stop_health_monitor() = 0;
 };
\ No newline at end of file
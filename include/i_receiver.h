@@ -8,5 +8,8 @@ public:
     virtual ~i_receiver() = default;
     virtual void operator()() = 0;  // Main thread function
     virtual std::optional<message> receive_message() = 0;
+    virtual std::optional<message> receive_message_until(uint64_t deadline_ns) = 0;
     virtual std::vector<message> receive_batch(size_t max_messages) = 0;
+    // Appends up to max_messages to out, waiting no later than deadline_ns
+    virtual size_t receive_batch_until(std::vector<message>& out, size_t max_messages, uint64_t deadline_ns) = 0;
 };
\ No newline at end of file
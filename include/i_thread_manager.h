@@ -1,4 +1,5 @@
 #pragma once
+#include <Windows.h>
 #include <string>
 
 class i_thread_manager {
@@ -10,4 +11,6 @@ public:
 
     virtual bool add_input_sender_context(const std::string& process_id, int instance) = 0;
     virtual bool remove_input_sender_context(const std::string& process_id, int instance) = 0;
+    // Points a running input sender at a new window, the others keep running
+    virtual bool retarget_input_sender_context(const std::string& process_id, int instance, HWND window) = 0;
 };
\ No newline at end of file
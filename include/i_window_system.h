@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "i_input_injector.h"
+
+enum class window_event_type {
+    created,    // A top-level window appeared, its title may still be empty
+    destroyed,
+    retitled
+};
+
+struct window_event {
+    window_event_type type{window_event_type::created};
+    window_handle window{nullptr};
+    uint32_t pid{0};
+};
+
+struct window_info {
+    window_handle handle{nullptr};
+    uint32_t pid{0};
+    std::string title;
+    std::string class_name;
+};
+
+// A process started through the window system. handle is the native process
+// handle (HANDLE on Windows), owned by whoever keeps the launched_process.
+struct launched_process {
+    void* handle{nullptr};
+    uint32_t pid{0};
+};
+
+// Processes and top-level windows of the desktop. Window changes are
+// delivered as events so callers never need to rescan; list_handles() is
+// for the initial attach and as a fallback. Events are for one consumer.
+class i_window_system {
+public:
+    virtual ~i_window_system() = default;
+
+    virtual bool start() = 0;  // Begins delivering events
+    virtual void stop() = 0;   // Also releases a thread blocked in next_event()
+    // Blocks until an event is available or deadline_ns (a now_ns() timestamp)
+    // passes. Returns false on timeout or once the system is stopped.
+    virtual bool next_event(window_event& event, uint64_t deadline_ns) = 0;
+
+    // Visible windows in z-order. Cheap, nothing about the windows is fetched.
+    virtual std::vector<window_handle> list_handles() const = 0;
+    // Title, class and owning process, false once the window is gone
+    virtual bool describe(window_handle window, window_info& info) const = 0;
+    virtual std::string window_title(window_handle window) const = 0;
+    virtual bool is_window(window_handle window) const = 0;
+
+    virtual bool launch(const std::string& path, const std::vector<std::string>& args,
+                        launched_process& process) = 0;
+    virtual void terminate(launched_process& process) = 0;
+    virtual void release(launched_process& process) = 0;  // Closes the handle, the process keeps running
+    // Process that started pid, 0 when unknown. Stays known after the parent exits.
+    virtual uint32_t parent_pid(uint32_t pid) const = 0;
+    virtual bool post_key(window_handle window, uint16_t vk_code, bool down) = 0;
+
+    virtual const char* name() const = 0;
+};
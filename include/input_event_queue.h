@@ -0,0 +1,30 @@
+#pragma once
+#include <atomic>
+#include "i_input_source.h"
+#include "platform_hints.h"
+#include "wait_strategy.h"
+
+// Bounded single-producer/single-consumer queue handing input events from
+// the thread that captures them to the key monitor thread.
+class input_event_queue {
+public:
+    static constexpr size_t CAPACITY = 256;
+
+    explicit input_event_queue(const wait_config& wait = wait_config{});
+
+    bool push(const input_event& event);  // Producer side, false when full
+    bool pop(input_event& event, uint64_t deadline_ns);
+    void open();
+    void close();  // Wakes the consumer, pop() fails until reopened
+    uint64_t dropped() const { return dropped_events.load(std::memory_order_relaxed); }
+
+private:
+    input_event slots[CAPACITY];
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+    std::atomic<uint64_t> dropped_events{0};
+
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> accepting{false};
+    wait_strategy waiter;
+};
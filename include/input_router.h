@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "message_channel.h"
+
+class broadcast_ring;
+
+// Selects input senders by integer ids, -1 matches any process or instance
+struct target_selector {
+    int process_index{-1};
+    int instance{-1};
+};
+
+// Dense ids for the input senders and bitmask fan-out over them. Every
+// (process index, instance) pair registered at startup becomes an id below
+// MAX_TARGETS, so a set of windows is a uint64_t and routing an action is
+// a few bit operations with no string lookups. Senders that share a
+// broadcast ring are reached with one publish.
+class input_router {
+public:
+    static constexpr int MAX_TARGETS = 64;
+
+    // Returns the target id, or -1 when all ids are taken
+    int add_target(int process_index, int instance, std::shared_ptr<message_channel> channel);
+    // The id stops receiving; its channel stays alive for in-flight fan-outs
+    void remove_target(int id);
+    void clear();
+
+    int find_target(int process_index, int instance) const;
+    uint64_t resolve(const target_selector& selector) const;
+    uint64_t resolve(const std::vector<target_selector>& selectors) const;
+    uint64_t active_targets() const { return active.load(std::memory_order_acquire); }
+    const target_selector& target(int id) const { return targets[id].selector; }
+    std::shared_ptr<message_channel> channel(int id) const;
+
+    // Pushes msg to every target in mask under each channel's overflow
+    // policy. Returns the targets it reached.
+    uint64_t fan_out(const message& msg, uint64_t mask);
+    void wake_all();
+
+private:
+    struct target_slot {
+        target_selector selector;
+        std::shared_ptr<message_channel> channel;
+        broadcast_ring* ring{nullptr};  // Set when channel is a broadcast_channel view
+        uint64_t reader_mask{0};
+    };
+
+    target_slot targets[MAX_TARGETS];
+    int target_count{0};
+    std::atomic<uint64_t> active{0};
+    mutable std::mutex targets_mutex;  // Registration only, fan_out reads published slots
+};
@@ -3,12 +3,20 @@
 #include "message_channel.h"
 #include "sender.h"
 #include "receiver.h"
+#include "latency_histogram.h"
+#include "i_input_injector.h"
+#include "timer_wheel.h"
+#include "timing_service.h"
+#include "strand_pool.h"
+#include "broadcast_barrier.h"
+#include "circuit_breaker.h"
 #include <Windows.h>
 #include <memory>
 #include <atomic>
+#include <deque>
 #include <thread>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 class input_sender_context : public i_thread_context {
 public:
@@ -25,25 +33,95 @@ public:
     void process_message(const message& msg) override;
     void print_metrics() const override;
     void set_name(const std::string& name) override;
+    // Run as a strand on the pool instead of on a thread of its own, call before start()
+    void set_strand_pool(strand_pool* pool) { worker_pool = pool; }
+    // From any thread. The sender switches to window before its next injection.
+    void retarget(HWND window);
 
 private:
+    // Fine enough that tick rounding stays well below a millisecond
+    static constexpr uint64_t RELEASE_TICK_NS = 50'000;
+    static constexpr size_t MAX_BURST = 64;  // Messages taken from the channel per wakeup
+    static constexpr uint64_t PARK_POLL_NS = 50'000'000;  // Parked senders still notice shutdown this fast
+
+    struct held_key {
+        bool down{false};
+        bool extended{false};
+        uint16_t scan_code{0};
+        uint32_t generation{0};  // Bumped on every key down
+    };
+
+    struct pending_release {
+        uint16_t vk_code;
+        uint32_t generation;     // Of the key down this release belongs to
+    };
+
     std::shared_ptr<message_channel> outbound_channel;
     std::shared_ptr<message_channel> inbound_channel;
     std::atomic<bool>& running;
     std::thread worker_thread;
+    strand_pool* worker_pool{nullptr};
+    strand* worker_strand{nullptr};
     sender msg_sender;
     receiver msg_receiver;
     std::string context_name;
     std::atomic<size_t> messages_processed{0};
     std::atomic<size_t> messages_sent{0};
     std::atomic<size_t> inputs_sent{0};
+    std::atomic<size_t> messages_dropped{0};     // Discarded while the window was unhealthy
+    std::atomic<size_t> injection_timeouts{0};
+    std::atomic<size_t> retargets{0};
+
+    // Per-stage latency of key events, from detection in the key monitor
+    // to the end of injection into the window
+    struct latency_trace {
+        latency_histogram detect_to_enqueue;
+        latency_histogram enqueue_to_dequeue;
+        latency_histogram dequeue_to_inject;
+        latency_histogram injection;
+        latency_histogram end_to_end;
+    } latency;
+    uint64_t dequeue_ns{0};      // When the message being processed left the channel
     HWND target_hwnd;
+    std::atomic<HWND> next_hwnd{nullptr};  // Set by retarget(), taken by the sender
     std::string process_id;      // Added to store process ID
+    int process_index;           // Integer id carried in message::target_process
     int instance_number;         // Added to store instance number
+    std::unique_ptr<i_input_injector> injector;
+    circuit_breaker breaker;
+    held_key held_keys[256];
+    std::vector<message> batch;
+    // A parked sender on a broadcast ring still has to consume, or the
+    // ring fills up for every other window. Its keys wait here instead,
+    // the oldest are dropped beyond the channel capacity.
+    bool shares_ring;
+    std::deque<message> parked_backlog;
+    std::vector<key_transition> burst;
+    std::vector<const message*> burst_messages;
+    timer_wheel<pending_release> key_releases{RELEASE_TICK_NS};
+    timing_service& timing{timing_service::get_instance()};
+    broadcast_barrier& barrier{broadcast_barrier::get_instance()};
+    uint16_t last_sync_token{0};  // Later keys of a moment this window already joined skip the barrier
 
     // Helper functions
-    void send_key_to_window(const std::string& key_name);
-    WORD get_virtual_key_code(const std::string& key_name);
-    void simulate_key_press(WORD vk_code);
-    void simulate_key_combination(const std::vector<WORD>& vk_codes);
+    uint64_t run_once();  // Strand body, returns when the next key-up is due
+    void handle_batch();
+    void process_batch(const message* messages, size_t count);
+    void inject_burst(uint16_t sync_token);  // Injects the queued keys of burst_messages
+    void simulate_key_combination(const std::vector<WORD>& vk_codes, uint64_t hold_ns);
+    // Key transitions are collected into the burst and delivered together
+    void queue_key_down(uint16_t vk_code, uint16_t scan_code, bool extended);
+    void queue_key_up(uint16_t vk_code);
+    size_t flush_burst();
+    void discard_burst(uint16_t sync_token);
+    bool parked() const;
+    void stash_parked(size_t count);
+    bool take_backlog();
+    void adopt_window();
+    void probe_if_due();
+    void schedule_release(uint16_t vk_code, uint64_t release_ns);
+    void release_due_keys(bool spin);
+    void release_all_keys();
+    static std::unique_ptr<i_input_injector> create_injector(const std::string& process_id);
+    static breaker_config load_breaker_config(const std::string& process_id);
 };
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "input_router.h"
+
+struct KeyAction {
+    std::string key;
+    int delay{0};  // Delay in milliseconds after this key press
+    int hold{0};   // Milliseconds between key down and key up, defaults to key_hold_ms
+    uint16_t vk_code{0};    // Resolved from key at load time, 0 for a pure delay
+    uint16_t scan_code{0};
+    bool extended{false};
+};
+
+// Named set of windows, e.g. "healers". Members are "process" for every
+// instance or "process:instance" for one.
+struct TargetGroup {
+    std::string name;
+    std::vector<target_selector> members;
+};
+
+struct KeySequence {
+    std::string target_process;
+    std::string group;       // Alternative to target_process, names a TargetGroup
+    int instance{-1};        // -1 for every instance of target_process
+    int process_index{-1};  // Resolved from target_process at load time, -1 if unknown
+    std::vector<target_selector> targets;  // Windows this sequence reaches, empty if none resolved
+    std::vector<KeyAction> actions;
+};
+
+struct KeyBinding {
+    std::string trigger_key;
+    uint16_t trigger_vk{0};  // Resolved from trigger_key at load time, 0 if unknown
+    bool synchronous{false}; // Keys due at the same time reach all windows together
+    int sync_timeout_ms{0};  // Longest a window waits for the others at the barrier
+    std::vector<KeySequence> sequences;
+};
@@ -0,0 +1,308 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Every key the settings can name. Virtual-key codes are the Windows ones
+// and scan codes are set 1 for a US layout, so the whole table resolves at
+// compile time and nothing is looked up per keystroke. Aliases come after
+// the canonical name of a key, which is the one vk_to_key_name() reports.
+struct key_info {
+    std::string_view name;
+    uint16_t vk_code;
+    uint16_t scan_code;
+    bool extended;  // Sent with the E0 prefix, flagged in the lParam
+};
+
+inline constexpr key_info KEY_TABLE[] = {
+    {"Backspace", 0x08, 0x0E, false},
+    {"Tab", 0x09, 0x0F, false},
+    {"Enter", 0x0D, 0x1C, false},
+    {"Return", 0x0D, 0x1C, false},
+    {"Shift", 0x10, 0x2A, false},
+    {"Ctrl", 0x11, 0x1D, false},
+    {"Control", 0x11, 0x1D, false},
+    {"Alt", 0x12, 0x38, false},
+    {"Pause", 0x13, 0x45, false},
+    {"CapsLock", 0x14, 0x3A, false},
+    {"Esc", 0x1B, 0x01, false},
+    {"Escape", 0x1B, 0x01, false},
+    {"Space", 0x20, 0x39, false},
+    {"PageUp", 0x21, 0x49, true},
+    {"PageDown", 0x22, 0x51, true},
+    {"End", 0x23, 0x4F, true},
+    {"Home", 0x24, 0x47, true},
+    {"Left", 0x25, 0x4B, true},
+    {"Up", 0x26, 0x48, true},
+    {"Right", 0x27, 0x4D, true},
+    {"Down", 0x28, 0x50, true},
+    {"PrintScreen", 0x2C, 0x37, true},
+    {"Insert", 0x2D, 0x52, true},
+    {"Delete", 0x2E, 0x53, true},
+    {"0", 0x30, 0x0B, false},
+    {"1", 0x31, 0x02, false},
+    {"2", 0x32, 0x03, false},
+    {"3", 0x33, 0x04, false},
+    {"4", 0x34, 0x05, false},
+    {"5", 0x35, 0x06, false},
+    {"6", 0x36, 0x07, false},
+    {"7", 0x37, 0x08, false},
+    {"8", 0x38, 0x09, false},
+    {"9", 0x39, 0x0A, false},
+    {"A", 0x41, 0x1E, false},
+    {"B", 0x42, 0x30, false},
+    {"C", 0x43, 0x2E, false},
+    {"D", 0x44, 0x20, false},
+    {"E", 0x45, 0x12, false},
+    {"F", 0x46, 0x21, false},
+    {"G", 0x47, 0x22, false},
+    {"H", 0x48, 0x23, false},
+    {"I", 0x49, 0x17, false},
+    {"J", 0x4A, 0x24, false},
+    {"K", 0x4B, 0x25, false},
+    {"L", 0x4C, 0x26, false},
+    {"M", 0x4D, 0x32, false},
+    {"N", 0x4E, 0x31, false},
+    {"O", 0x4F, 0x18, false},
+    {"P", 0x50, 0x19, false},
+    {"Q", 0x51, 0x10, false},
+    {"R", 0x52, 0x13, false},
+    {"S", 0x53, 0x1F, false},
+    {"T", 0x54, 0x14, false},
+    {"U", 0x55, 0x16, false},
+    {"V", 0x56, 0x2F, false},
+    {"W", 0x57, 0x11, false},
+    {"X", 0x58, 0x2D, false},
+    {"Y", 0x59, 0x15, false},
+    {"Z", 0x5A, 0x2C, false},
+    {"LWin", 0x5B, 0x5B, true},
+    {"RWin", 0x5C, 0x5C, true},
+    {"Apps", 0x5D, 0x5D, true},
+    {"Numpad0", 0x60, 0x52, false},
+    {"Numpad1", 0x61, 0x4F, false},
+    {"Numpad2", 0x62, 0x50, false},
+    {"Numpad3", 0x63, 0x51, false},
+    {"Numpad4", 0x64, 0x4B, false},
+    {"Numpad5", 0x65, 0x4C, false},
+    {"Numpad6", 0x66, 0x4D, false},
+    {"Numpad7", 0x67, 0x47, false},
+    {"Numpad8", 0x68, 0x48, false},
+    {"Numpad9", 0x69, 0x49, false},
+    {"NumpadMultiply", 0x6A, 0x37, false},
+    {"NumpadAdd", 0x6B, 0x4E, false},
+    {"NumpadSubtract", 0x6D, 0x4A, false},
+    {"NumpadDecimal", 0x6E, 0x53, false},
+    {"NumpadDivide", 0x6F, 0x35, true},
+    {"F1", 0x70, 0x3B, false},
+    {"F2", 0x71, 0x3C, false},
+    {"F3", 0x72, 0x3D, false},
+    {"F4", 0x73, 0x3E, false},
+    {"F5", 0x74, 0x3F, false},
+    {"F6", 0x75, 0x40, false},
+    {"F7", 0x76, 0x41, false},
+    {"F8", 0x77, 0x42, false},
+    {"F9", 0x78, 0x43, false},
+    {"F10", 0x79, 0x44, false},
+    {"F11", 0x7A, 0x57, false},
+    {"F12", 0x7B, 0x58, false},
+    {"F13", 0x7C, 0x64, false},
+    {"F14", 0x7D, 0x65, false},
+    {"F15", 0x7E, 0x66, false},
+    {"F16", 0x7F, 0x67, false},
+    {"F17", 0x80, 0x68, false},
+    {"F18", 0x81, 0x69, false},
+    {"F19", 0x82, 0x6A, false},
+    {"F20", 0x83, 0x6B, false},
+    {"F21", 0x84, 0x6C, false},
+    {"F22", 0x85, 0x6D, false},
+    {"F23", 0x86, 0x6E, false},
+    {"F24", 0x87, 0x76, false},
+    {"NumLock", 0x90, 0x45, true},
+    {"ScrollLock", 0x91, 0x46, false},
+    {"LShift", 0xA0, 0x2A, false},
+    {"RShift", 0xA1, 0x36, false},
+    {"LCtrl", 0xA2, 0x1D, false},
+    {"RCtrl", 0xA3, 0x1D, true},
+    {"LAlt", 0xA4, 0x38, false},
+    {"RAlt", 0xA5, 0x38, true},
+    {"Semicolon", 0xBA, 0x27, false},
+    {"Equals", 0xBB, 0x0D, false},
+    {"Comma", 0xBC, 0x33, false},
+    {"Minus", 0xBD, 0x0C, false},
+    {"Period", 0xBE, 0x34, false},
+    {"Slash", 0xBF, 0x35, false},
+    {"Backquote", 0xC0, 0x29, false},
+    {"LeftBracket", 0xDB, 0x1A, false},
+    {"Backslash", 0xDC, 0x2B, false},
+    {"RightBracket", 0xDD, 0x1B, false},
+    {"Quote", 0xDE, 0x28, false},
+};
+
+constexpr size_t KEY_COUNT = sizeof(KEY_TABLE) / sizeof(KEY_TABLE[0]);
+
+// Seeded FNV-1a with a final mix, seed 0 picks the bucket
+constexpr uint32_t key_name_hash(std::string_view name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    hash ^= hash >> 12;
+    return hash;
+}
+
+// Perfect hash over the key names, built with hash-and-displace: names are
+// grouped into buckets, and each bucket gets the smallest seed that sends
+// all of its names to free slots. A lookup is two hashes and one compare.
+struct key_name_index {
+    static constexpr size_t BUCKETS = 64;
+    static constexpr size_t SLOTS = 256;
+    static constexpr uint16_t MAX_SEED = 4096;
+
+    std::array<uint16_t, BUCKETS> seeds{};   // 0 for an empty bucket
+    std::array<uint16_t, SLOTS> entries{};   // KEY_COUNT for a free slot
+    bool complete{false};
+};
+
+constexpr key_name_index build_key_name_index() {
+    key_name_index index;
+    for (auto& entry : index.entries) {
+        entry = KEY_COUNT;
+    }
+
+    std::array<size_t, key_name_index::BUCKETS> sizes{};
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        sizes[key_name_hash(KEY_TABLE[i].name, 0) % key_name_index::BUCKETS]++;
+    }
+
+    // Fullest buckets first, they are the hardest to place
+    for (size_t size = KEY_COUNT; size > 0; --size) {
+        for (size_t bucket = 0; bucket < key_name_index::BUCKETS; ++bucket) {
+            if (sizes[bucket] != size) {
+                continue;
+            }
+            size_t members[KEY_COUNT] = {};
+            size_t count = 0;
+            for (size_t i = 0; i < KEY_COUNT; ++i) {
+                if (key_name_hash(KEY_TABLE[i].name, 0) % key_name_index::BUCKETS == bucket) {
+                    members[count++] = i;
+                }
+            }
+
+            bool placed = false;
+            for (uint16_t seed = 1; seed < key_name_index::MAX_SEED && !placed; ++seed) {
+                size_t slots[KEY_COUNT] = {};
+                placed = true;
+                for (size_t m = 0; m < count && placed; ++m) {
+                    slots[m] = key_name_hash(KEY_TABLE[members[m]].name, seed) % key_name_index::SLOTS;
+                    placed = index.entries[slots[m]] == KEY_COUNT;
+                    for (size_t other = 0; other < m && placed; ++other) {
+                        placed = slots[other] != slots[m];
+                    }
+                }
+                if (placed) {
+                    index.seeds[bucket] = seed;
+                    for (size_t m = 0; m < count; ++m) {
+                        index.entries[slots[m]] = static_cast<uint16_t>(members[m]);
+                    }
+                }
+            }
+            if (!placed) {
+                return index;
+            }
+        }
+    }
+    index.complete = true;
+    return index;
+}
+
+inline constexpr key_name_index KEY_NAME_INDEX = build_key_name_index();
+static_assert(KEY_NAME_INDEX.complete, "No perfect hash found for the key names");
+
+constexpr std::array<uint16_t, 256> build_key_vk_index() {
+    std::array<uint16_t, 256> index{};
+    for (auto& entry : index) {
+        entry = KEY_COUNT;
+    }
+    for (size_t i = KEY_COUNT; i > 0; --i) {
+        index[KEY_TABLE[i - 1].vk_code & 0xFF] = static_cast<uint16_t>(i - 1);  // First name wins
+    }
+    return index;
+}
+
+inline constexpr std::array<uint16_t, 256> KEY_VK_INDEX = build_key_vk_index();
+
+// Single letters are accepted in either case, everything else is exact
+constexpr const key_info* find_key(std::string_view name) {
+    char upper[1] = {};
+    if (name.size() == 1 && name[0] >= 'a' && name[0] <= 'z') {
+        upper[0] = static_cast<char>(name[0] - 'a' + 'A');
+        name = std::string_view(upper, 1);
+    }
+    uint16_t seed = KEY_NAME_INDEX.seeds[key_name_hash(name, 0) % key_name_index::BUCKETS];
+    if (seed == 0) {
+        return nullptr;
+    }
+    uint16_t entry = KEY_NAME_INDEX.entries[key_name_hash(name, seed) % key_name_index::SLOTS];
+    if (entry == KEY_COUNT || KEY_TABLE[entry].name != name) {
+        return nullptr;
+    }
+    return &KEY_TABLE[entry];
+}
+
+constexpr const key_info* find_key(uint16_t vk_code) {
+    if (vk_code > 0xFF || KEY_VK_INDEX[vk_code] == KEY_COUNT) {
+        return nullptr;
+    }
+    return &KEY_TABLE[KEY_VK_INDEX[vk_code]];
+}
+
+// Virtual-key code for a settings key name ("A", "F5", "Numpad3", ...), 0 if unknown
+constexpr uint16_t key_name_to_vk(std::string_view key_name) {
+    const key_info* key = find_key(key_name);
+    return key ? key->vk_code : 0;
+}
+
+// Empty for keys the table does not name
+constexpr std::string_view vk_to_key_name(uint16_t vk_code) {
+    const key_info* key = find_key(vk_code);
+    return key ? key->name : std::string_view();
+}
+
+// Hardware scan code for a virtual-key code, as placed in WM_KEYDOWN's lParam
+constexpr uint16_t vk_to_scan_code(uint16_t vk_code) {
+    const key_info* key = find_key(vk_code);
+    return key ? key->scan_code : 0;
+}
+
+constexpr bool vk_is_extended(uint16_t vk_code) {
+    const key_info* key = find_key(vk_code);
+    return key && key->extended;
+}
+
+// WM_KEYDOWN/WM_KEYUP lParam: repeat count 1, scan code, extended flag, and
+// for a key up the previous-state and transition bits
+constexpr uint32_t key_lparam(uint16_t scan_code, bool extended, bool down) {
+    return 1u
+         | (static_cast<uint32_t>(scan_code & 0xFF) << 16)
+         | (extended ? 1u << 24 : 0u)
+         | (down ? 0u : 0xC0000000u);
+}
+
+// Left and right virtual keys of a generic modifier (Shift, Ctrl, Alt).
+// Low-level hooks only report the sided codes. Returns false for any other key.
+constexpr bool modifier_sides(uint16_t vk_code, uint16_t& left, uint16_t& right) {
+    switch (vk_code) {
+        case 0x10: left = 0xA0; right = 0xA1; return true;
+        case 0x11: left = 0xA2; right = 0xA3; return true;
+        case 0x12: left = 0xA4; right = 0xA5; return true;
+        default: return false;
+    }
+}
+
+static_assert(key_name_to_vk("F5") == 0x74 && key_name_to_vk("q") == 'Q' && key_name_to_vk("Nope") == 0,
+              "Key name lookup is broken");
+static_assert(vk_to_key_name(0x0D) == "Enter", "VK to name lookup is broken");
@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "message_types.h"
+#include "latency_histogram.h"
+#include "timer_wheel.h"
+#include "broadcast_barrier.h"
+#include "input_router.h"
+#include "key_bindings.h"
+
+// One key of a sequence timeline with its message built ahead of time. The
+// message id and timestamps are filled in at dispatch.
+struct dispatch_step {
+    message msg;
+    uint64_t offset_ns{0};  // From the trigger, the sum of all earlier delays
+};
+
+// Destination of one key sequence. Sequences with identical actions are
+// merged into a single group, so each action is fanned out once over the
+// combined target mask.
+struct fan_out_group {
+    const KeySequence* sequence;
+    uint64_t targets{0};  // input_router ids
+    int16_t target_process{-1};
+    int16_t target_instance{-1};
+    std::vector<dispatch_step> steps;
+};
+
+// Keys of a synchronous binding that are due at the same offset. They share
+// one broadcast_barrier, so every window injects them together.
+struct sync_moment {
+    struct entry {
+        const fan_out_group* group;
+        uint32_t step;
+    };
+    uint64_t offset_ns{0};
+    uint32_t windows{0};  // Distinct input senders the entries reach
+    std::vector<entry> entries;
+};
+
+// Everything a trigger key does, compiled from its binding when the monitor
+// starts so a key-down needs no lookups or allocations.
+struct dispatch_plan {
+    const KeyBinding* binding;
+    std::vector<fan_out_group> groups;
+    std::vector<sync_moment> moments;  // Synchronous bindings run these instead of the groups
+};
+
+// Rest of a sequence waiting out an action delay. For synchronous bindings
+// group is null and next_step indexes the plan's moments.
+struct scheduled_step {
+    const dispatch_plan* plan;
+    const fan_out_group* group;
+    uint32_t next_step;
+    uint64_t detected_ns;
+};
+
+// Turns trigger keys into timed key messages for the input senders. Each
+// binding is compiled into a timeline of offsets from the trigger; keys due
+// at the trigger go out from on_key_down(), later ones from run_due(). The
+// owner calls both from one thread, so the channels keep a single producer.
+class key_dispatcher {
+public:
+    explicit key_dispatcher(input_router& router, broadcast_barrier& barrier = broadcast_barrier::get_instance())
+        : router(router), barrier(barrier) {}
+
+    // Bindings must outlive the dispatcher and their targets be registered
+    // in the router. process_ids name router process indexes in log output;
+    // pool_workers is the strand pool size, 0 when senders have threads.
+    void compile(const std::vector<KeyBinding>& bindings, const std::vector<std::string>& process_ids,
+                 size_t pool_workers);
+    void on_key_down(uint16_t vk_code, uint64_t detected_ns);
+    uint64_t next_deadline() const { return action_timers.next_deadline(); }
+    void run_due(uint64_t now_ns);
+
+    size_t bindings() const { return dispatch_plans.size(); }
+    size_t keys_processed() const { return keys_count.load(std::memory_order_relaxed); }
+    size_t messages_sent() const { return sent_count.load(std::memory_order_relaxed); }
+    size_t messages_dropped() const { return dropped_count.load(std::memory_order_relaxed); }
+    void print_metrics() const;
+
+private:
+    // Fine enough that tick rounding stays well below a millisecond
+    static constexpr uint64_t ACTION_TICK_NS = 50'000;
+
+    void start(const scheduled_step& pending, uint64_t first_offset_ns);
+    void run_steps(const scheduled_step& pending);
+    void run_moment(const scheduled_step& pending);
+    uint64_t dispatch_step_message(const scheduled_step& pending, const fan_out_group& group,
+                                   const dispatch_step& step, uint16_t sync_token);
+    std::vector<fan_out_group> build_fan_out_groups(const KeyBinding& binding) const;
+    static std::vector<sync_moment> build_sync_moments(const std::vector<fan_out_group>& groups);
+    void warn_if_pool_too_small(const dispatch_plan& plan, size_t pool_workers) const;
+    uint64_t send_action(const fan_out_group& group, message& key_msg);
+
+    input_router& router;
+    broadcast_barrier& barrier;
+    std::vector<std::string> process_names;
+    std::vector<dispatch_plan> dispatch_plans;
+    std::array<const dispatch_plan*, 256> dispatch_table{};  // Indexed by virtual key
+    uint32_t next_msg_id{0};
+    timer_wheel<scheduled_step> action_timers{ACTION_TICK_NS};
+    std::atomic<size_t> keys_count{0};
+    std::atomic<size_t> sent_count{0};
+    std::atomic<size_t> dropped_count{0};     // Target channel was full
+    latency_histogram detect_to_enqueue;
+    latency_histogram timeline_jitter;  // Dispatch time minus timeline time of delayed steps
+};
@@ -3,11 +3,17 @@
 #include "message_channel.h"
 #include "sender.h"
 #include "receiver.h"
+#include "i_input_source.h"
+#include "timing_service.h"
+#include "key_dispatcher.h"
 #include <Windows.h>
 #include <memory>
 #include <atomic>
 #include <thread>
 #include <string>
+#include <vector>
+
+struct InputConfig;
 
 class key_monitor_context : public i_thread_context {
 public:
@@ -31,9 +37,10 @@ private:
     receiver msg_receiver;
     std::string context_name;
     std::atomic<size_t> messages_processed{0};
-    std::atomic<size_t> messages_sent{0};
-    std::atomic<size_t> keys_processed{0};
+    std::unique_ptr<i_input_source> input;
+    timing_service& timing{timing_service::get_instance()};
+    key_dispatcher dispatcher;
 
-    // Helper function to convert virtual key code to string
-    std::string get_key_name(DWORD vk_code);
+    static std::unique_ptr<i_input_source> create_input_source(const InputConfig& config);
+    void compile_dispatch_table();
 };
\ No newline at end of file
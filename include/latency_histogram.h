@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// Log-linear histogram in the style of HdrHistogram: every power of two is
+// split into 16 linear sub-buckets, so any recorded value is reported with
+// about 6% resolution from nanoseconds up to minutes. Recording is a few
+// relaxed atomic adds, safe from any thread.
+class latency_histogram {
+public:
+    latency_histogram();
+
+    void record(uint64_t value_ns);
+    void reset();
+
+    uint64_t count() const { return total_count.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_value.load(std::memory_order_relaxed); }
+    double mean() const;
+    uint64_t percentile(double p) const;  // Upper bound of the bucket holding the p-th value
+
+    // One line: count, p50, p99, p99.9 and max in microseconds
+    void print(std::ostream& out, const char* label) const;
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static int bucket_index(uint64_t value);
+    static uint64_t bucket_upper_bound(int index);
+
+    std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> total_count{0};
+    std::atomic<uint64_t> total_sum{0};
+    std::atomic<uint64_t> max_value{0};
+};
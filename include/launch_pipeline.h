@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "i_window_system.h"
+#include "timer_wheel.h"
+#include "title_matcher.h"
+#include "window_registry.h"
+
+enum class launch_step_type {
+    wait_window,  // For a new window of the process, it becomes the current window
+    wait_title,   // For a window of the process, current or new, to carry a title
+    send_keys     // Posts keys to the current window
+};
+
+// One step of a client's launch script. Wait steps advance the moment a
+// matching window or title is seen and fail after timeout_ms.
+struct launch_step {
+    launch_step_type type{launch_step_type::wait_window};
+    std::string pattern;                                  // Wait steps, empty matches any titled window
+    title_match_mode match{title_match_mode::contains};
+    std::vector<uint16_t> keys;                           // Virtual-key codes, pressed in turn
+    uint32_t delay_ms{0};                                 // Before the first key
+    uint32_t hold_ms{0};                                  // Between key down and key up
+    uint32_t timeout_ms{60000};
+};
+
+// One client to start. Without steps the client is expected to show
+// window_sequence windows in turn, Enter on each but the last opening the
+// next one.
+struct launch_spec {
+    std::string id;
+    int instance{0};
+    std::string path;
+    std::vector<std::string> args;
+    int window_sequence{1};
+    std::vector<launch_step> steps;
+};
+
+enum class launch_state {
+    waiting_window,
+    waiting_title,
+    sending_keys,
+    ready,
+    failed
+};
+
+struct launch_result {
+    launch_spec spec;
+    launched_process process;
+    window_handle window{nullptr};  // The current window once the script is done
+    std::string title;
+    launch_state state{launch_state::waiting_window};
+    std::string error;
+    uint64_t elapsed_ns{0};         // Launch to ready or failure
+};
+
+// Launches every client at once and runs each one's launch script with a
+// small state machine. Windows and titles are detected from window events
+// attributed by process id, so clients never wait on each other and
+// nothing polls; a slow rescan only covers missed events. Windows of
+// processes the client started, even after it exited, count as its own.
+// A new window no launch can be traced to goes to the first client waiting
+// for a title pattern it matches.
+class launch_pipeline {
+public:
+    static constexpr uint64_t RESCAN_INTERVAL_NS = 5'000'000'000;
+
+    launch_pipeline(i_window_system& windows, window_registry& registry)
+        : windows(windows), registry(registry) {}
+
+    // The window system must be started and the registry built on it. Returns one result per spec, in order.
+    std::vector<launch_result> run(const std::vector<launch_spec>& specs);
+    // From any thread. Launches still in progress fail, and so does every
+    // later run until reset().
+    void cancel() { cancelled = true; }
+    void reset() { cancelled = false; }
+
+private:
+    static constexpr uint64_t TIMER_TICK_NS = 1'000'000;
+    static constexpr size_t RESCAN = SIZE_MAX;  // Timer task index of the rescan
+    static constexpr int MAX_ANCESTRY = 8;      // Parents followed from a window's process
+
+    struct task {
+        launch_result result;
+        std::vector<launch_step> steps;
+        std::vector<title_matcher> matchers;            // One per step, empty for send_keys
+        size_t step{0};
+        size_t key{0};                                  // Next key of a send_keys step
+        bool key_down{false};
+        uint32_t generation{0};                         // Bumped on every transition, stale timers compare it
+        uint64_t started_ns{0};
+        std::unordered_set<window_handle> alive;       // Windows of the process
+        std::unordered_set<window_handle> old_windows; // Already there when the step began
+    };
+
+    struct timer {
+        size_t task;
+        uint32_t generation;
+    };
+
+    task* task_of(uint32_t pid);
+    task* claim_by_title(window_handle window, uint32_t pid);
+    void on_event(const window_event& event, uint64_t now);
+    void on_timer(const timer& fired, uint64_t now);
+    void consider(task& t, window_handle window, uint64_t now);
+    void begin_step(task& t, uint64_t now);
+    void send_keys(task& t, uint64_t now);
+    void enter_state(task& t, launch_state state, uint64_t deadline_ns);
+    std::string step_name(const task& t) const;
+    void finish(task& t, uint64_t now);
+    void fail(task& t, const std::string& error, uint64_t now);
+    void rescan(uint64_t now);
+
+    i_window_system& windows;
+    window_registry& registry;
+    std::vector<task> tasks;
+    std::unordered_map<uint32_t, size_t> task_by_pid;      // Launched processes and their descendants
+    std::unordered_set<uint32_t> unrelated_pids;           // Traced back to no launch
+    std::unordered_set<window_handle> existing_windows;    // Before the launches, never claimed by title
+    timer_wheel<timer> timers{TIMER_TICK_NS};
+    size_t pending{0};
+    std::atomic<bool> cancelled{false};
+};
+
+// The script the fixed launcher handling used to run: wait for a window,
+// give it time to handle input, press Enter, repeat
+std::vector<launch_step> default_launch_steps(int window_sequence);
+
+const char* launch_state_name(launch_state state);
+bool parse_launch_step_type(const std::string& name, launch_step_type& type);
+const char* launch_step_type_name(launch_step_type type);
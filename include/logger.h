@@ -0,0 +1,231 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "platform_hints.h"
+
+enum class log_level : uint8_t {
+    trace = 0,
+    debug = 1,
+    info = 2,
+    warn = 3,
+    error = 4,
+    off = 5
+};
+
+// Records below this level are compiled out entirely
+#ifndef WC_LOG_LEVEL
+#define WC_LOG_LEVEL 1
+#endif
+
+// Argument captured by value when a record is written. Strings are copied
+// into the record, so the caller's buffers may go away before formatting.
+struct log_arg {
+    enum class kind : uint8_t { signed_int, unsigned_int, floating, boolean, character, pointer, string };
+    kind type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        bool b;
+        char c;
+        const void* p;
+        struct {
+            uint16_t offset;
+            uint16_t length;
+        } str;
+    };
+};
+
+struct log_record {
+    static constexpr int MAX_ARGS = 8;
+    static constexpr size_t TEXT_CAPACITY = 128;
+
+    const char* format;  // Must be a string literal, "{}" and "{:x}" are replaced by arguments
+    uint64_t timestamp_ns;
+    uint32_t thread_index;
+    log_level level;
+    uint8_t arg_count;
+    uint16_t text_used;
+    log_arg args[MAX_ARGS];
+    char text[TEXT_CAPACITY];
+};
+
+// Lock-free single-producer ring owned by one logging thread and drained by
+// the logger's background thread.
+class log_buffer {
+public:
+    static constexpr size_t CAPACITY = 512;
+
+    explicit log_buffer(uint32_t thread_index) : thread_index(thread_index) {}
+
+    log_record* begin_write();
+    void commit_write();
+    // Consumer side, in place: records readable now, the oldest, and done with it
+    size_t readable() const;
+    const log_record& front() const { return records[head.load(std::memory_order_relaxed) % CAPACITY]; }
+    void pop() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    const uint32_t thread_index;
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> retired{false};  // Its thread exited, freed once drained
+
+private:
+    log_record records[CAPACITY];
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+};
+
+// Asynchronous logger. Hot-path threads only copy the format pointer and
+// arguments into their own log_buffer; a background thread formats the
+// records and writes them to the console in batches.
+class logger {
+public:
+    static logger& get_instance() {
+        static logger instance;
+        return instance;
+    }
+
+    void start();
+    void stop();  // Drains and flushes everything written so far
+    void set_output(std::ostream& stream) { output = &stream; }  // Call before start(), std::cout by default
+    void set_level(log_level level) { runtime_level.store(level, std::memory_order_relaxed); }
+    log_level get_level() const { return runtime_level.load(std::memory_order_relaxed); }
+    bool enabled(log_level level) const { return level >= get_level(); }
+    uint64_t dropped_records() const;
+    size_t thread_buffers() const;  // Of threads that logged and are alive or not yet drained
+
+    template <typename... Args>
+    void write(log_level level, const char* format, const Args&... args);
+
+private:
+    logger();
+    ~logger();
+    logger(const logger&) = delete;
+    logger& operator=(const logger&) = delete;
+
+    log_buffer& thread_buffer();
+    void run();
+    // Appends every pending record, merged across threads by timestamp
+    bool drain(std::string& out);
+    void reclaim_retired();
+    static void format_record(const log_record& record, uint64_t start_ns, std::string& out);
+
+    template <typename T>
+    static void capture(log_record& record, const T& value);
+    static void capture_string(log_record& record, const char* value, size_t length);
+
+    std::atomic<log_level> runtime_level{log_level::info};
+    mutable std::mutex buffers_mutex;
+    std::vector<std::shared_ptr<log_buffer>> buffers;
+    std::atomic<uint32_t> next_thread_index{0};
+    std::atomic<uint64_t> retired_dropped{0};  // Drop counts of reclaimed buffers
+    std::ostream* output;
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    uint64_t start_ns{0};
+};
+
+template <typename T>
+void logger::capture(log_record& record, const T& value) {
+    if (record.arg_count >= log_record::MAX_ARGS) {
+        return;
+    }
+    log_arg& arg = record.args[record.arg_count++];
+    using type = std::decay_t<T>;
+    if constexpr (std::is_same_v<type, bool>) {
+        arg.type = log_arg::kind::boolean;
+        arg.b = value;
+    } else if constexpr (std::is_same_v<type, char>) {
+        arg.type = log_arg::kind::character;
+        arg.c = value;
+    } else if constexpr (std::is_enum_v<type>) {
+        arg.type = log_arg::kind::signed_int;
+        arg.i = static_cast<int64_t>(value);
+    } else if constexpr (std::is_integral_v<type> && std::is_signed_v<type>) {
+        arg.type = log_arg::kind::signed_int;
+        arg.i = value;
+    } else if constexpr (std::is_integral_v<type>) {
+        arg.type = log_arg::kind::unsigned_int;
+        arg.u = value;
+    } else if constexpr (std::is_floating_point_v<type>) {
+        arg.type = log_arg::kind::floating;
+        arg.d = value;
+    } else if constexpr (std::is_same_v<type, std::string> || std::is_same_v<type, std::string_view>) {
+        record.arg_count--;
+        capture_string(record, value.data(), value.size());
+    } else if constexpr (std::is_same_v<type, const char*> || std::is_same_v<type, char*>) {
+        record.arg_count--;
+        capture_string(record, value, value ? std::strlen(value) : 0);
+    } else if constexpr (std::is_pointer_v<type>) {
+        arg.type = log_arg::kind::pointer;
+        arg.p = value;
+    } else {
+        static_assert(std::is_pointer_v<type>, "Unsupported log argument type");
+    }
+}
+
+template <typename... Args>
+void logger::write(log_level level, const char* format, const Args&... args) {
+    if (!enabled(level)) {
+        return;
+    }
+    log_buffer& buffer = thread_buffer();
+    log_record* record = buffer.begin_write();
+    if (!record) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    record->format = format;
+    record->level = level;
+    record->arg_count = 0;
+    record->text_used = 0;
+    (capture(*record, args), ...);
+    buffer.commit_write();
+    if (level >= log_level::warn) {
+        wake_cv.notify_one();
+    }
+}
+
+#define WC_LOG(level, ...) logger::get_instance().write(level, __VA_ARGS__)
+
+#if WC_LOG_LEVEL <= 0
+#define LOG_TRACE(...) WC_LOG(log_level::trace, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) ((void)0)
+#endif
+
+#if WC_LOG_LEVEL <= 1
+#define LOG_DEBUG(...) WC_LOG(log_level::debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if WC_LOG_LEVEL <= 2
+#define LOG_INFO(...) WC_LOG(log_level::info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if WC_LOG_LEVEL <= 3
+#define LOG_WARN(...) WC_LOG(log_level::warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#define LOG_ERROR(...) WC_LOG(log_level::error, __VA_ARGS__)
+
+bool parse_log_level(const std::string& name, log_level& level);
+const char* log_level_name(log_level level);
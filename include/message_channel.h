@@ -1,12 +1,59 @@
 #pragma once
-#include <queue>
-#include <mutex>
-#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
 #include "message_types.h"
+#include "wait_strategy.h"
+#include "overflow_policy.h"
 
-struct message_channel {
-    std::mutex mutex;
-    std::condition_variable cv;
-    std::queue<message> messages;
+enum class channel_type {
+    mutex_queue,    // std::queue behind a mutex, any number of producers/consumers
+    spsc_ring,      // Bounded lock-free ring, exactly one producer and one consumer
+    broadcast_ring  // One ring shared by all input senders, see broadcast_channel.h
+};
+
+class message_channel {
+public:
     static constexpr size_t MAX_QUEUE_SIZE = 1000;
-};
\ No newline at end of file
+
+    virtual ~message_channel() = default;
+
+    virtual bool try_push(const message& msg) = 0;
+    // try_push under the channel's overflow policy. False when msg was
+    // dropped; a coalesced msg counts as delivered.
+    virtual bool push(const message& msg);
+    virtual bool try_push_batch(const std::vector<message>& messages) = 0;  // All or nothing
+    virtual bool try_pop(message& msg) = 0;
+    virtual size_t try_pop_batch(std::vector<message>& out, size_t max_messages) = 0;
+
+    // Blocks, according to the channel's wait strategy, until a message may
+    // be available or running is cleared
+    virtual void wait_for_messages(const std::atomic<bool>& running) = 0;
+    // Gives up at deadline_ns (a now_ns() timestamp), true when messages are ready
+    virtual bool wait_for_messages_until(const std::atomic<bool>& running, uint64_t deadline_ns) = 0;
+    virtual void wake_all() = 0;
+    // Called after every push, for consumers that are scheduled rather than waiting
+    virtual void set_wakeup_listener(wakeup_listener* listener) = 0;
+
+    virtual size_t size() const = 0;
+    virtual size_t capacity() const = 0;
+    virtual const char* type_name() const = 0;
+    virtual wait_stats get_wait_stats() const = 0;
+
+    virtual void set_overflow(const overflow_config& config) { overflow.configure(config); }
+    virtual overflow_stats get_overflow_stats() const { return overflow.stats(); }
+
+protected:
+    // Producer-side hooks for push(), false when the channel cannot do it
+    virtual bool coalesce_newest(const message&) { return false; }
+    virtual bool evict_oldest() { return false; }
+
+    overflow_guard overflow;
+};
+
+std::shared_ptr<message_channel> make_message_channel(channel_type type = channel_type::mutex_queue,
+                                                      size_t capacity = message_channel::MAX_QUEUE_SIZE,
+                                                      const wait_config& wait = wait_config{});
+bool parse_channel_type(const std::string& name, channel_type& type);
+const char* channel_type_name(channel_type type);
@@ -1,18 +1,43 @@
 #pragma once
-#include <string>
 #include <cstdint>
+#include <type_traits>
 
+enum class message_command : uint16_t {
+    none = 0,
+    text = 1,       // Generic traffic between thread contexts and the sender/receiver drivers
+    key_press = 2   // Key down followed by key up in the target window
+};
+
+enum key_event_flags : uint16_t {
+    KEY_FLAG_NONE = 0,
+    KEY_FLAG_EXTENDED = 1 << 0,    // Extended scan code (arrows, right Ctrl/Alt, ...)
+    KEY_FLAG_SYNC = 1 << 1         // Injected together with the other windows, see sync_token
+};
+
+// Fixed-size, trivially copyable so channels can move it with a plain copy.
+// Keys and targets are resolved to integers when the settings are loaded.
 struct message {
-    uint32_t m_command;
-    uint32_t m_msg_id;
-    std::string m_msg;
-    std::string target_process_id;  
-    int target_instance;           
+    message_command m_command{message_command::none};
+    uint16_t m_flags{KEY_FLAG_NONE};
+    uint32_t m_msg_id{0};
+    uint16_t vk_code{0};
+    uint16_t scan_code{0};
+    int16_t target_process{-1};    // Index into the process configs, -1 when routed by broadcast mask
+    int16_t target_instance{-1};   // -1 addresses every instance of the process
+    uint32_t hold_us{0};           // key_press: time between key down and key up
+    uint16_t sync_token{0};        // broadcast_barrier token when KEY_FLAG_SYNC is set
+    uint64_t timestamp_ns{0};      // Steady clock time the triggering key was detected
+    uint64_t enqueue_ns{0};        // Steady clock time the message was pushed to its channel
 
     message() = default;
-    message(uint32_t cmd, uint32_t id, std::string msg, 
-            std::string target_id = "", int target_inst = -1)
-        : m_command(cmd), m_msg_id(id), m_msg(std::move(msg))
-        , target_process_id(std::move(target_id))
-        , target_instance(target_inst) {}
-};
\ No newline at end of file
+    message(message_command cmd, uint32_t id, uint16_t vk = 0, uint16_t scan = 0,
+            int16_t target_proc = -1, int16_t target_inst = -1, uint64_t timestamp = 0)
+        : m_command(cmd), m_msg_id(id)
+        , vk_code(vk), scan_code(scan)
+        , target_process(target_proc)
+        , target_instance(target_inst)
+        , timestamp_ns(timestamp) {}
+};
+
+static_assert(std::is_trivially_copyable<message>::value, "message must be trivially copyable");
+static_assert(sizeof(message) <= 64, "message must fit in one cache line");
@@ -0,0 +1,33 @@
+#pragma once
+#include <deque>
+#include <mutex>
+#include "message_channel.h"
+
+class mutex_channel : public message_channel {
+public:
+    explicit mutex_channel(size_t capacity = MAX_QUEUE_SIZE, const wait_config& wait = wait_config{});
+
+    bool try_push(const message& msg) override;
+    bool try_push_batch(const std::vector<message>& messages) override;
+    bool try_pop(message& msg) override;
+    size_t try_pop_batch(std::vector<message>& out, size_t max_messages) override;
+    void wait_for_messages(const std::atomic<bool>& running) override;
+    bool wait_for_messages_until(const std::atomic<bool>& running, uint64_t deadline_ns) override;
+    void wake_all() override;
+    void set_wakeup_listener(wakeup_listener* listener) override { waiter.set_listener(listener); }
+    size_t size() const override;
+    size_t capacity() const override { return max_size; }
+    const char* type_name() const override { return "mutex"; }
+    wait_stats get_wait_stats() const override { return waiter.stats(); }
+
+protected:
+    bool coalesce_newest(const message& msg) override;
+    bool evict_oldest() override;
+
+private:
+    mutable std::mutex mutex;
+    std::deque<message> messages;
+    std::atomic<size_t> count{0};  // Mirrors messages.size() for lock-free readiness checks
+    size_t max_size;
+    wait_strategy waiter;
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "message_types.h"
+#include "platform_hints.h"
+#include "timing.h"
+
+enum class overflow_policy {
+    drop_newest,  // Reject the new message when the channel is full
+    drop_oldest,  // Evict the oldest queued message to make room
+    block,        // Wait up to block_timeout_us for room, then drop
+    coalesce      // When full, skip a repeat of the newest queued key from an earlier trigger, else drop
+};
+
+struct overflow_config {
+    overflow_policy policy{overflow_policy::drop_newest};
+    uint32_t block_timeout_us{1000};
+};
+
+struct overflow_stats {
+    uint64_t dropped{0};
+    uint64_t evicted{0};
+    uint64_t coalesced{0};
+    uint64_t blocked{0};     // Pushes that had to wait for room
+    size_t high_water{0};    // Most messages queued at once
+};
+
+// Same key to the same window, ignoring ids and timestamps
+inline bool same_key(const message& a, const message& b) {
+    return a.m_command == b.m_command && a.m_flags == b.m_flags &&
+           a.vk_code == b.vk_code && a.scan_code == b.scan_code &&
+           a.target_process == b.target_process && a.target_instance == b.target_instance &&
+           a.hold_us == b.hold_us && a.sync_token == b.sync_token;
+}
+
+// A repeat of a queued key that push() may skip under coalesce. Keys of the
+// same trigger share its timestamp and are never merged, a sequence that
+// presses a key twice means it.
+inline bool coalescible(const message& queued, const message& msg) {
+    return same_key(queued, msg) && queued.timestamp_ns != msg.timestamp_ns;
+}
+
+// Applies an overflow_config on the producer side of a channel and counts
+// what it did. The channel supplies the raw operations; channels that cannot
+// evict from the producer side report false and degrade to drop_newest.
+class overflow_guard {
+public:
+    void configure(const overflow_config& config) { cfg = config; }
+    const overflow_config& config() const { return cfg; }
+
+    template <typename TryPush, typename CoalesceNewest, typename EvictOldest>
+    bool push(TryPush try_push, CoalesceNewest coalesce_newest, EvictOldest evict_oldest) {
+        if (try_push()) {
+            return true;
+        }
+        switch (cfg.policy) {
+            case overflow_policy::coalesce:
+                // A key that is still queued is only dropped when there is no room
+                if (coalesce_newest()) {
+                    coalesced.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                break;
+            case overflow_policy::drop_oldest:
+                if (evict_oldest()) {
+                    evicted.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (try_push()) {
+                    return true;
+                }
+                break;
+            case overflow_policy::block: {
+                blocked.fetch_add(1, std::memory_order_relaxed);
+                uint64_t deadline_ns = now_ns() + uint64_t{cfg.block_timeout_us} * 1000;
+                for (int i = 0; now_ns() < deadline_ns; ++i) {
+                    if (try_push()) {
+                        return true;
+                    }
+                    if (i < BLOCK_SPIN_ITERATIONS) {
+                        cpu_relax();
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t high_water_mark() const { return high_water.load(std::memory_order_relaxed); }
+    void record_size(size_t size) {
+        if (size > high_water.load(std::memory_order_relaxed)) {
+            high_water.store(size, std::memory_order_relaxed);  // Producer side only
+        }
+    }
+
+    overflow_stats stats() const {
+        return overflow_stats{dropped.load(std::memory_order_relaxed),
+                              evicted.load(std::memory_order_relaxed),
+                              coalesced.load(std::memory_order_relaxed),
+                              blocked.load(std::memory_order_relaxed),
+                              high_water.load(std::memory_order_relaxed)};
+    }
+
+private:
+    static constexpr int BLOCK_SPIN_ITERATIONS = 64;
+
+    overflow_config cfg;
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> evicted{0};
+    std::atomic<uint64_t> coalesced{0};
+    std::atomic<uint64_t> blocked{0};
+    std::atomic<size_t> high_water{0};
+};
+
+bool parse_overflow_policy(const std::string& name, overflow_policy& policy);
+const char* overflow_policy_name(overflow_policy policy);
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <thread>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Fixed rather than std::hardware_destructive_interference_size so the
+// layout does not change between compilers.
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Spin-wait hint for busy loops
+inline void cpu_relax() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Ring buffers index with a mask, so capacities are rounded to a power of two
+inline size_t round_up_pow2(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Index of the most significant set bit, value must be non-zero
+inline int highest_bit(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+// Index of the least significant set bit, value must be non-zero
+inline int lowest_bit(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// Number of set bits
+inline int bit_count(uint64_t value) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(value));
+#else
+    return __builtin_popcountll(value);
+#endif
+}
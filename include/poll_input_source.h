@@ -0,0 +1,24 @@
+#pragma once
+#include <Windows.h>
+#include <atomic>
+#include <vector>
+#include "i_input_source.h"
+
+// Fallback source that scans GetAsyncKeyState for all 256 virtual keys once
+// per millisecond. Costs CPU and up to a scheduler tick of latency, use the
+// hook source where possible.
+class poll_input_source : public i_input_source {
+public:
+    bool start() override;
+    void stop() override { running = false; }
+    bool next_event(input_event& event, uint64_t deadline_ns) override;
+    const char* name() const override { return "poll"; }
+
+private:
+    void scan();
+
+    std::atomic<bool> running{false};
+    bool key_state[256] = {false};
+    std::vector<input_event> pending;
+    size_t pending_index{0};
+};
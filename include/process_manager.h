@@ -7,6 +7,10 @@
 #include <unordered_set>
 #include "settings_manager.h"
 #include "i_process_manager.h"
+#include "i_window_system.h"
+#include "window_registry.h"
+#include "title_matcher.h"
+#include "window_health_monitor.h"
 
 struct ProcessInstance {
     HANDLE process_handle;    // Will be nullptr for attached windows
@@ -16,18 +20,6 @@ struct ProcessInstance {
     std::string window_title;
 };
 
-struct WindowInfo {
-    HWND handle;
-    std::string title;
-    std::string class_name;
-};
-
-struct EnumWindowsCallbackArgs {
-    std::vector<WindowInfo>& windows;
-    const std::vector<ProcessConfig>& configs;
-    std::unordered_map<std::string, int>& instance_counts;
-};
-
 class ProcessManager : public i_process_manager {
 public:
     static ProcessManager& getInstance() {
@@ -38,22 +30,24 @@ public:
     bool launch_processes() override;
     HWND get_window_handle(const std::string& process_id, int instance = 0) const override;
     void terminate_processes() override;
+    bool start_health_monitor(window_replaced_listener listener) override;
+    void stop_health_monitor() override;
 
 private:
-    ProcessManager() = default;
+    ProcessManager();
     ~ProcessManager() = default;
     ProcessManager(const ProcessManager&) = delete;
     ProcessManager& operator=(const ProcessManager&) = delete;
 
     // Window scanning functions
     bool scan_and_attach_windows();
-    static BOOL CALLBACK enumWindowCallback(HWND handle, LPARAM param);
-    std::vector<WindowInfo> getAllWindows() const;
+    bool build_matcher();  // Compiles every config's title pattern once
+    void on_window_replaced(const monitored_client& client, window_handle window, const launched_process& process);
 
-    // Process launching functions
-    bool launchProcess(const ProcessConfig& config, int instance_num);
-    HWND findNewWindow(const std::vector<WindowInfo>& before_windows) const;
-    static BOOL CALLBACK enumWindowCallbackBasic(HWND handle, LPARAM param);
-    
     std::vector<ProcessInstance> process_instances;
+    std::unique_ptr<i_window_system> window_system;  // Launches clients and reports their windows
+    window_registry registry;                        // Client windows by handle and by process:instance
+    title_matcher matcher;                           // Window title to process config index
+    std::unique_ptr<window_health_monitor> health_monitor;  // Owns the registry while running
+    window_replaced_listener replaced_listener;
 };
\ No newline at end of file
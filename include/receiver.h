@@ -9,7 +9,9 @@ public:
     receiver(std::shared_ptr<message_channel> channel, std::atomic<bool>& running);
     void operator()() override;
     std::optional<message> receive_message() override;
+    std::optional<message> receive_message_until(uint64_t deadline_ns) override;
     std::vector<message> receive_batch(size_t max_messages) override;
+    size_t receive_batch_until(std::vector<message>& out, size_t max_messages, uint64_t deadline_ns) override;
 
 private:
     std::shared_ptr<message_channel> channel;
@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "i_input_injector.h"
+
+struct injected_key {
+    window_handle window;
+    uint16_t vk_code;
+    uint16_t scan_code;
+    bool extended;
+    bool down;
+    uint64_t timestamp_ns;
+};
+
+// Keeps every injected transition in memory instead of touching a window.
+// Lets the sender pipeline run and be measured on any platform. A response
+// delay stands in for a slow window: longer than the timeout, calls wait out
+// the timeout and fail like SendMessageTimeout on a hung window.
+class recording_injector : public i_input_injector {
+public:
+    bool key_down(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) override;
+    bool key_up(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) override;
+    const char* name() const override { return "recording"; }
+    size_t inject(window_handle window, const key_transition* keys, size_t count) override;
+    bool probe(window_handle window) override;
+
+    std::vector<injected_key> keys() const;
+    void clear();
+    void set_response_delay(uint64_t delay_ns) { response_delay_ns.store(delay_ns, std::memory_order_relaxed); }
+
+private:
+    bool respond();
+    bool record(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended, bool down);
+
+    mutable std::mutex keys_mutex;
+    std::vector<injected_key> recorded;
+    std::atomic<uint64_t> response_delay_ns{0};
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "i_input_source.h"
+
+// Plays back recorded key events. Each line of a replay file is
+//     <offset_ms> <down|up> <vk>
+// with the virtual key in decimal or 0x hex; '#' starts a comment. Offsets
+// are relative to start(). Unpaced replay delivers every event immediately.
+class replay_input_source : public i_input_source {
+public:
+    explicit replay_input_source(std::string path, bool paced = true);
+    explicit replay_input_source(std::vector<input_event> events, bool paced = true);
+
+    bool start() override;
+    void stop() override;
+    bool next_event(input_event& event, uint64_t deadline_ns) override;
+    const char* name() const override { return "replay"; }
+
+    bool finished() const { return next_index >= events.size(); }
+
+    static bool load_file(const std::string& path, std::vector<input_event>& events);
+
+private:
+    std::string path;
+    bool paced;
+    std::vector<input_event> events;  // timestamp_ns holds the offset from start
+    size_t next_index{0};
+    uint64_t start_ns{0};
+
+    std::atomic<bool> running{false};
+    std::mutex stop_mutex;
+    std::condition_variable stop_cv;
+};
@@ -5,30 +5,48 @@
 #include <unordered_map>
 #include <optional>
 #include <filesystem>
+#include "message_channel.h"
+#include "logger.h"
+#include "i_input_source.h"
+#include "i_input_injector.h"
+#include "strand_pool.h"
+#include "circuit_breaker.h"
+#include "input_router.h"
+#include "key_bindings.h"
+#include "title_matcher.h"
+#include "window_health_monitor.h"
+
+struct ChannelConfig {
+    channel_type type{channel_type::mutex_queue};
+    size_t capacity{message_channel::MAX_QUEUE_SIZE};
+    wait_config wait;                    // How the receiving thread waits on an empty channel
+    overflow_config overflow;            // What the key monitor does when the channel is full
+};
+
+struct InputConfig {
+    input_source_type source{input_source_type::hook};
+    std::string replay_file;             // Only used by the replay source
+    bool paced{true};                    // Replay at recorded offsets instead of as fast as possible
+};
+
+struct ExecutionConfig {
+    execution_mode mode{execution_mode::threads};
+    size_t workers{0};                   // Strand pool size, 0 for one per hardware thread
+};
 
 struct ProcessConfig {
     std::string id;                      // Identifier to match in window title
+    std::string title_pattern;           // What window titles are matched against, defaults to id
+    title_match_mode match{title_match_mode::contains};
     int instances;                       // Maximum number of instances to look for
     bool auto_launch;                    // Whether to launch if window not found
     std::string executable_path;         // Path to executable (only used if auto_launch is true)
     std::vector<std::string> args;       // Launch arguments (only used if auto_launch is true)
     int window_sequence;                 // Number of windows in sequence (only used if auto_launch is true)
-};
-
-struct KeyAction {
-    std::string key;
-    int delay{0};  // Delay in milliseconds after this key press
-};
-
-struct KeySequence {
-    std::string target_process;
-    int instance{0};
-    std::vector<KeyAction> actions;
-};
-
-struct KeyBinding {
-    std::string trigger_key;
-    std::vector<KeySequence> sequences;
+    std::vector<launch_step> launch_steps;  // Launch script, derived from window_sequence when not given
+    ChannelConfig channel;               // Inbound channel of the input sender for this process
+    injector_type injector{injector_type::send_message};  // How keys are delivered to its windows
+    breaker_config breaker;              // Injection timeout and handling of hung windows
 };
 
 class SettingsManager {
@@ -41,13 +59,43 @@ public:
     bool initialize();
     const std::vector<ProcessConfig>& getProcessConfigs() const { return process_configs; }
     const std::vector<KeyBinding>& getKeyBindings() const { return key_bindings; }
+    const ChannelConfig& getChannelConfig() const { return channel_config; }
+    log_level getLogLevel() const { return log_level_setting; }
+    const InputConfig& getInputConfig() const { return input_config; }
+    const ExecutionConfig& getExecutionConfig() const { return execution_config; }
+    const health_config& getHealthConfig() const { return health; }
+    const std::vector<TargetGroup>& getTargetGroups() const { return target_groups; }
+    const TargetGroup* findTargetGroup(const std::string& name) const;
+    const ProcessConfig* findProcessConfig(const std::string& id) const;
+    int findProcessIndex(const std::string& id) const;
     void printSettings() const;
 
 private:
+    static constexpr int DEFAULT_KEY_HOLD_MS = 50;
+    static constexpr int DEFAULT_SYNC_TIMEOUT_MS = 10;
+
     SettingsManager() = default;
     bool loadSettings(const std::filesystem::path& filepath);
     std::filesystem::path getSettingsPath() const;
+    static bool parseChannelConfig(const nlohmann::json& json, ChannelConfig& config);
+    static bool parseInputConfig(const nlohmann::json& json, InputConfig& config);
+    static bool parseBreakerConfig(const nlohmann::json& json, breaker_config& config);
+    static bool parseExecutionConfig(const nlohmann::json& json, ExecutionConfig& config);
+    static bool parseHealthConfig(const nlohmann::json& json, health_config& config);
+    static bool parseInjectorType(const nlohmann::json& json, injector_type& type);
+    static bool parseTitleMatch(const nlohmann::json& json, ProcessConfig& config);
+    static bool parseLaunchStep(const nlohmann::json& json, launch_step& step);
+    bool parseTargetGroup(const std::string& name, const nlohmann::json& json, TargetGroup& group) const;
     
     std::vector<ProcessConfig> process_configs;
     std::vector<KeyBinding> key_bindings;
+    std::vector<TargetGroup> target_groups;
+    ChannelConfig channel_config;
+    log_level log_level_setting{log_level::info};
+    InputConfig input_config;
+    ExecutionConfig execution_config;
+    health_config health;
+    injector_type default_injector{injector_type::send_message};
+    breaker_config default_breaker;
+    int key_hold_ms{DEFAULT_KEY_HOLD_MS};
 };
\ No newline at end of file
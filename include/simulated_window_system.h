@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "i_window_system.h"
+#include "window_event_queue.h"
+
+// How a simulated executable behaves once launched. Its first window opens
+// startup_ns after launch; Enter on window i closes it and opens window
+// i + 1 step_ns later, like a launcher and login screen in front of a client.
+// A program that spawns another starts it as a child at startup_ns and
+// exits instead, like a bootstrapper.
+struct simulated_program {
+    std::vector<std::string> titles{"Client"};
+    uint64_t startup_ns{0};
+    uint64_t step_ns{0};
+    std::string spawns;
+};
+
+// In-memory processes and windows for running the launch and attach code on
+// any platform. Scheduled window changes happen in real time, applied by
+// whichever call looks at the desktop next.
+class simulated_window_system : public i_window_system {
+public:
+    bool start() override;
+    void stop() override;
+    bool next_event(window_event& event, uint64_t deadline_ns) override;
+
+    std::vector<window_handle> list_handles() const override;
+    bool describe(window_handle window, window_info& info) const override;
+    std::string window_title(window_handle window) const override;
+    bool is_window(window_handle window) const override;
+
+    bool launch(const std::string& path, const std::vector<std::string>& args,
+                launched_process& process) override;
+    void terminate(launched_process& process) override;
+    void release(launched_process& process) override { process.handle = nullptr; }
+    uint32_t parent_pid(uint32_t pid) const override;
+    bool post_key(window_handle window, uint16_t vk_code, bool down) override;
+
+    const char* name() const override { return "simulated"; }
+
+    // Launching any other path fails
+    void add_program(const std::string& path, const simulated_program& program);
+    // Windows not owned by a launched process, e.g. ones that exist before attach
+    window_handle create_window(uint32_t pid, const std::string& title);
+    void destroy_window(window_handle window);
+    void set_title(window_handle window, const std::string& title);
+    // The process dies with all its windows, like a client crash
+    void crash(uint32_t pid);
+    size_t keys_posted() const;
+    size_t describe_calls() const;  // How many windows had their details fetched
+
+private:
+    struct sim_window {
+        uint32_t pid;
+        std::string title;
+        size_t step;  // Index into the program's titles, SIZE_MAX for external windows
+    };
+
+    struct sim_process {
+        const simulated_program* program;
+        bool alive;
+        uint32_t parent;
+    };
+
+    struct pending_window {
+        uint64_t due_ns;
+        uint32_t pid;
+        size_t step;  // SPAWN when the process starts its child instead
+    };
+
+    static constexpr size_t SPAWN = SIZE_MAX;
+
+    // Callers hold mutex
+    void catch_up() const;
+    uint32_t start_process(const simulated_program& program, uint32_t parent) const;
+    window_handle add_window(uint32_t pid, const std::string& title, size_t step) const;
+    void remove_window(window_handle window) const;
+    void kill(uint32_t pid);
+    void notify(window_event_type type, window_handle window, uint32_t pid) const;
+    uint64_t next_due() const;
+
+    mutable std::mutex mutex;
+    mutable std::unordered_map<window_handle, sim_window> windows;
+    mutable std::vector<window_handle> z_order;  // Newest first, like the desktop
+    mutable std::vector<pending_window> pending;
+    mutable std::unordered_map<uint32_t, sim_process> processes;
+    std::unordered_map<std::string, simulated_program> programs;
+    mutable window_event_queue queue;
+    mutable uintptr_t next_window{0x10000};
+    mutable uint32_t next_pid{1000};
+    size_t posted{0};
+    mutable size_t described{0};
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include "message_channel.h"
+#include "platform_hints.h"
+
+// Bounded single-producer/single-consumer ring. Push and pop are wait-free;
+// how the consumer waits on an empty ring is up to its wait_strategy.
+class spsc_channel : public message_channel {
+public:
+    explicit spsc_channel(size_t capacity = MAX_QUEUE_SIZE, const wait_config& wait = wait_config{});
+
+    bool try_push(const message& msg) override;
+    bool try_push_batch(const std::vector<message>& messages) override;
+    bool try_pop(message& msg) override;
+    size_t try_pop_batch(std::vector<message>& out, size_t max_messages) override;
+    void wait_for_messages(const std::atomic<bool>& running) override;
+    bool wait_for_messages_until(const std::atomic<bool>& running, uint64_t deadline_ns) override;
+    void wake_all() override;
+    void set_wakeup_listener(wakeup_listener* listener) override { waiter.set_listener(listener); }
+    size_t size() const override;
+    size_t capacity() const override { return mask + 1; }
+    const char* type_name() const override { return "spsc"; }
+    wait_stats get_wait_stats() const override { return waiter.stats(); }
+
+protected:
+    // Only the consumer may advance head, so drop_oldest degrades to drop_newest
+    bool coalesce_newest(const message& msg) override;
+
+private:
+    size_t mask;
+    std::unique_ptr<message[]> slots;
+
+    // Consumer-owned line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    size_t cached_tail{0};
+
+    // Producer-owned line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+    size_t cached_head{0};
+
+    alignas(CACHE_LINE_SIZE) wait_strategy waiter;
+};
@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "platform_hints.h"
+#include "timer_wheel.h"
+#include "timing.h"
+#include "timing_service.h"
+#include "wait_strategy.h"
+
+enum class execution_mode {
+    threads,  // One OS thread per input sender
+    pool      // Input senders run as strands on a shared strand_pool
+};
+
+class strand_pool;
+
+// Serial unit of work on a strand_pool. The body never runs on two workers
+// at once, so whatever it consumes keeps its order; different strands run
+// in parallel. The body returns when it next wants to run (NO_DEADLINE for
+// never), and wake() makes it run as soon as a worker is free. A wake that
+// arrives while the body runs makes it run once more afterwards.
+class strand : public wakeup_listener {
+public:
+    using body_type = std::function<uint64_t()>;
+
+    strand(strand_pool& pool, body_type body) : owner(pool), body(std::move(body)) {}
+
+    void wake() override;
+
+private:
+    friend class strand_pool;
+
+    enum state_value : int { idle, queued, running, running_woken };
+
+    strand_pool& owner;
+    body_type body;
+    std::atomic<int> state{idle};
+    std::atomic<bool> retired{false};
+    uint64_t timer_deadline{NO_DEADLINE};  // Guarded by the pool's timer_mutex
+};
+
+// Fixed set of workers running any number of strands. Each worker has its
+// own run queue; woken strands are spread over the queues round-robin and a
+// worker whose queue is empty steals from the back of the others before it
+// sleeps. Strand deadlines live in one timer wheel, waited on by one idle
+// worker at a time with the timing_service's sleep-then-spin.
+class strand_pool {
+public:
+    explicit strand_pool(size_t worker_count = 0);  // 0 uses one worker per hardware thread
+    ~strand_pool();
+
+    void start();
+    void stop();  // Joins the workers, strands still queued do not run
+
+    // The pool owns the strand, it stays valid until the pool is destroyed
+    strand* add_strand(strand::body_type body);
+    // Waits for a running body to return; the strand never runs again
+    void retire(strand* s);
+
+    size_t worker_count() const { return queues.size(); }
+    void print_metrics() const;
+
+private:
+    // Coarse enough to keep the wheel small, fine against key hold times
+    static constexpr uint64_t TIMER_TICK_NS = 50'000;
+
+    struct alignas(CACHE_LINE_SIZE) run_queue {
+        std::mutex mutex;
+        std::deque<strand*> strands;
+    };
+
+    friend class strand;
+    void schedule(strand* s);
+    void enqueue(strand* s, size_t queue_index);
+    strand* take_work(size_t worker);
+    void run_strand(strand* s, size_t worker);
+    void run_worker(size_t worker);
+    void idle();
+    void set_deadline(strand* s, uint64_t deadline_ns);
+    void fire_due_timers();
+    void wake_idle_workers(bool all);
+
+    std::vector<std::unique_ptr<run_queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<bool> running{false};
+    std::atomic<size_t> next_queue{0};
+    std::atomic<size_t> queued{0};
+    std::atomic<int> sleeping{0};
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+
+    mutable std::mutex strands_mutex;
+    std::vector<std::unique_ptr<strand>> strands;
+
+    std::atomic<bool> timer_keeper{false};  // Set while an idle worker waits for the next deadline
+    std::mutex timer_mutex;
+    timer_wheel<strand*> timers{TIMER_TICK_NS};
+    std::atomic<uint64_t> next_timer{NO_DEADLINE};
+    timing_service& timing{timing_service::get_instance()};
+
+    std::atomic<uint64_t> runs{0};
+    std::atomic<uint64_t> steals{0};
+    std::atomic<uint64_t> timer_wakeups{0};
+};
+
+bool parse_execution_mode(const std::string& name, execution_mode& mode);
+const char* execution_mode_name(execution_mode mode);
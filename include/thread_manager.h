@@ -5,10 +5,14 @@
 #include "thread_context.h"
 #include "i_thread_manager.h"
 #include "message_channel.h"
+#include "broadcast_channel.h"
+#include "strand_pool.h"
+#include "input_router.h"
 
 struct ContextInfo {
     std::shared_ptr<message_channel> outbound_channel;  // Changed from channel_to_input
     std::unique_ptr<i_thread_context> context;          // Removed channel_from_input
+    int target_id{-1};                                  // Id of its inbound channel in the router
 };
 
 class thread_manager : public i_thread_manager {
@@ -22,17 +26,19 @@ public:
     
     bool add_input_sender_context(const std::string& process_id, int instance) override;
     bool remove_input_sender_context(const std::string& process_id, int instance) override;
+    bool retarget_input_sender_context(const std::string& process_id, int instance, HWND window) override;
     
-    // Add getter for input channels
-    static std::shared_ptr<message_channel> get_input_channel(const std::string& context_id) {
-        auto it = input_channels.find(context_id);
-        return (it != input_channels.end()) ? it->second : nullptr;
+    // Inbound channels of the input senders, addressed by integer target id
+    static input_router& get_router() {
+        return router;
     }
 
 private:
     std::unique_ptr<i_thread_context> key_monitor_context;
     std::shared_ptr<message_channel> key_monitor_outbound;
     std::unordered_map<std::string, ContextInfo> input_contexts;
-    static std::unordered_map<std::string, std::shared_ptr<message_channel>> input_channels;
+    static input_router router;
+    std::shared_ptr<broadcast_ring> broadcast_bus;  // Shared by senders configured with "broadcast"
+    std::unique_ptr<strand_pool> sender_pool;       // Runs the input senders in "pool" execution mode
     std::atomic<bool> running{true};
 };
\ No newline at end of file
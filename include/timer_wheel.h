@@ -0,0 +1,188 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "platform_hints.h"
+#include "timing.h"
+
+// Hierarchical timer wheel: four levels of 64 slots, each level 64 times
+// coarser than the one below. Scheduling is O(1); timers further out than
+// the top level are parked in its farthest slot and re-placed as the wheel
+// turns. Timers fire on the first tick boundary at or after their deadline,
+// never early. Single-threaded, the owner calls advance() from its loop.
+template <typename T>
+class timer_wheel {
+public:
+    explicit timer_wheel(uint64_t tick_ns = 1'000'000, uint64_t start_ns = now_ns())
+        : tick_ns(tick_ns), current_tick(start_ns / tick_ns) {}
+
+    void schedule(uint64_t deadline_ns, T item) {
+        place(entry{deadline_ns, std::move(item)});
+        next_deadline_ns = std::min(next_deadline_ns, deadline_ns);
+        ++count;
+    }
+
+    // Fires every timer due at now_ns, calling fire(item, deadline_ns).
+    // Callbacks may schedule new timers, including ones already due.
+    template <typename Fire>
+    size_t advance(uint64_t now_ns, Fire fire);
+
+    // Deadline of the earliest pending timer, NO_DEADLINE when empty
+    uint64_t next_deadline() const;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    uint64_t tick() const { return tick_ns; }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+    static_assert(SLOTS <= 64, "occupied has one bit per slot");
+    static_assert(SLOT_BITS * LEVELS < 64, "the range of the top level must fit in a tick count");
+
+    struct entry {
+        uint64_t deadline_ns;
+        T item;
+    };
+
+    struct level {
+        uint64_t occupied{0};  // Bit per non-empty slot
+        std::vector<entry> slots[SLOTS];
+    };
+
+    uint64_t deadline_tick(uint64_t deadline_ns) const {
+        return (deadline_ns + tick_ns - 1) / tick_ns;
+    }
+
+    void place(entry e);
+    void cascade(int level_index);
+    template <typename Fire>
+    size_t fire_all(std::vector<entry>& list, Fire& fire);
+
+    uint64_t tick_ns;
+    uint64_t current_tick;  // Every tick before this one has been processed
+    size_t count{0};
+    level levels[LEVELS];
+    std::vector<entry> overdue;  // Scheduled for a tick already processed
+    std::vector<entry> firing;
+    mutable uint64_t next_deadline_ns{NO_DEADLINE};
+    mutable bool next_deadline_stale{false};
+};
+
+template <typename T>
+void timer_wheel<T>::place(entry e) {
+    uint64_t due = deadline_tick(e.deadline_ns);
+    if (due < current_tick) {
+        overdue.push_back(std::move(e));
+        return;
+    }
+    uint64_t delta = due - current_tick;
+    int level_index = 0;
+    while (level_index < LEVELS - 1 && delta >= (uint64_t{1} << (SLOT_BITS * (level_index + 1)))) {
+        ++level_index;
+    }
+    uint64_t range = uint64_t{1} << (SLOT_BITS * LEVELS);
+    if (delta >= range) {
+        due = current_tick + range - 1;  // Re-placed when its slot cascades
+    }
+    size_t slot = (due >> (SLOT_BITS * level_index)) & SLOT_MASK;
+    levels[level_index].slots[slot].push_back(std::move(e));
+    levels[level_index].occupied |= uint64_t{1} << slot;
+}
+
+template <typename T>
+void timer_wheel<T>::cascade(int level_index) {
+    size_t slot = (current_tick >> (SLOT_BITS * level_index)) & SLOT_MASK;
+    level& source = levels[level_index];
+    if (!(source.occupied & (uint64_t{1} << slot))) {
+        return;
+    }
+    std::vector<entry> moving;
+    moving.swap(source.slots[slot]);
+    source.occupied &= ~(uint64_t{1} << slot);
+    for (auto& e : moving) {
+        place(std::move(e));
+    }
+}
+
+template <typename T>
+template <typename Fire>
+size_t timer_wheel<T>::fire_all(std::vector<entry>& list, Fire& fire) {
+    firing.swap(list);
+    count -= firing.size();
+    next_deadline_stale = true;
+    size_t fired = firing.size();
+    for (auto& e : firing) {
+        fire(e.item, e.deadline_ns);
+    }
+    firing.clear();
+    return fired;
+}
+
+template <typename T>
+template <typename Fire>
+size_t timer_wheel<T>::advance(uint64_t now_ns, Fire fire) {
+    uint64_t target_tick = now_ns / tick_ns;
+    size_t fired = 0;
+    while (!overdue.empty()) {
+        fired += fire_all(overdue, fire);
+    }
+    while (current_tick <= target_tick && count > 0) {
+        // Entering a new rotation of a level pulls the matching slot of the
+        // level above down, starting from the coarsest level that turned.
+        for (int l = LEVELS - 1; l > 0; --l) {
+            if ((current_tick & ((uint64_t{1} << (SLOT_BITS * l)) - 1)) == 0) {
+                cascade(l);
+            }
+        }
+
+        size_t index = current_tick & SLOT_MASK;
+        level& wheel = levels[0];
+        while ((wheel.occupied & (uint64_t{1} << index)) || !overdue.empty()) {
+            if (wheel.occupied & (uint64_t{1} << index)) {
+                wheel.occupied &= ~(uint64_t{1} << index);
+                fired += fire_all(wheel.slots[index], fire);
+            } else {
+                fired += fire_all(overdue, fire);
+            }
+        }
+
+        // Jump to the next occupied slot of this rotation or its end
+        uint64_t ahead = index + 1 < SLOTS ? wheel.occupied >> (index + 1) << (index + 1) : 0;
+        uint64_t next_tick = ahead ? (current_tick & ~SLOT_MASK) + lowest_bit(ahead)
+                                   : (current_tick | SLOT_MASK) + 1;
+        current_tick = std::min(next_tick, target_tick + 1);
+    }
+    if (count == 0) {
+        current_tick = std::max(current_tick, target_tick + 1);
+        next_deadline_ns = NO_DEADLINE;
+        next_deadline_stale = false;
+    }
+    return fired;
+}
+
+template <typename T>
+uint64_t timer_wheel<T>::next_deadline() const {
+    if (next_deadline_stale) {
+        next_deadline_ns = NO_DEADLINE;
+        for (const auto& e : overdue) {
+            next_deadline_ns = std::min(next_deadline_ns, e.deadline_ns);
+        }
+        for (const auto& wheel : levels) {
+            for (uint64_t bits = wheel.occupied; bits; bits &= bits - 1) {
+                for (const auto& e : wheel.slots[lowest_bit(bits)]) {
+                    next_deadline_ns = std::min(next_deadline_ns, e.deadline_ns);
+                }
+            }
+        }
+        next_deadline_stale = false;
+    }
+    // Nothing fires before the tick boundary holding the deadline
+    if (next_deadline_ns == NO_DEADLINE) {
+        return NO_DEADLINE;
+    }
+    return deadline_tick(next_deadline_ns) * tick_ns;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Monotonic timestamp in nanoseconds, used to stamp events
+inline uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Deadline value meaning "wait until woken"
+constexpr uint64_t NO_DEADLINE = UINT64_MAX;
+
+inline std::chrono::steady_clock::time_point to_steady_time(uint64_t timestamp_ns) {
+    return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(timestamp_ns));
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Precise waits for action timelines. An OS sleep alone overshoots by up to
+// a scheduler tick, so waits sleep until a margin before the deadline and
+// spin the rest. The margin starts from a calibration run and follows the
+// oversleep observed at runtime: it jumps up on a late wakeup and decays
+// slowly while wakeups are on time.
+class timing_service {
+public:
+    static timing_service& get_instance() {
+        static timing_service instance;
+        return instance;
+    }
+
+    void sleep_until(uint64_t deadline_ns);
+    void spin_until(uint64_t deadline_ns);
+
+    // Where a coarse wait for deadline_ns should end to leave room for the spin
+    uint64_t coarse_deadline(uint64_t deadline_ns) const;
+    // Feeds the margin with the lateness of a coarse wait that timed out
+    void record_wakeup(uint64_t requested_ns, uint64_t woke_ns);
+
+    uint64_t spin_margin_ns() const { return margin_ns.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint64_t MIN_MARGIN_NS = 50'000;
+    static constexpr uint64_t MAX_MARGIN_NS = 4'000'000;
+    static constexpr uint64_t GUARD_NS = 100'000;
+
+    timing_service();
+    ~timing_service();
+    timing_service(const timing_service&) = delete;
+    timing_service& operator=(const timing_service&) = delete;
+
+    void calibrate();
+    void os_sleep_until(uint64_t deadline_ns);
+
+    std::atomic<uint64_t> margin_ns{MAX_MARGIN_NS};
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <vector>
+
+enum class title_match_mode {
+    contains,  // Pattern anywhere in the title, the historical behaviour
+    exact,     // Whole title
+    prefix,    // Start of the title
+    regex      // ECMAScript regex searched anywhere in the title
+};
+
+// Matches window titles against every configured pattern at once. Literal
+// patterns are compiled into one Aho-Corasick automaton, so a title costs a
+// single pass over its characters however many patterns there are; regex
+// patterns are tried after it. When several patterns match, the longest
+// match wins, then the pattern added first.
+class title_matcher {
+public:
+    // id is returned by match(), usually the process config index
+    void add(const std::string& pattern, title_match_mode mode, int id);
+    bool compile();  // False when a regex does not parse
+    int match(const std::string& title) const;  // Best id, or -1
+    size_t size() const { return patterns.size(); }
+
+private:
+    struct pattern {
+        std::string text;
+        title_match_mode mode;
+        int id;
+        std::regex compiled;  // Regex mode only
+    };
+
+    struct node {
+        std::vector<int> next;         // Full transition table over the alphabet
+        int fail{0};
+        int output_link{-1};           // Nearest node on the fail chain that ends a pattern
+        std::vector<int> ends;         // Patterns ending exactly here
+    };
+
+    int add_node();
+    void consider(int index, size_t start, size_t length, size_t title_length,
+                  int& best, size_t& best_length) const;
+
+    std::vector<pattern> patterns;
+    std::vector<node> nodes;
+    uint16_t alphabet[256]{};  // Byte to symbol, 0 for bytes in no pattern
+    int alphabet_size{1};      // Up to 257 when patterns use every byte
+    std::vector<int> regex_patterns;
+};
+
+bool parse_title_match_mode(const std::string& name, title_match_mode& mode);
+const char* title_match_mode_name(title_match_mode mode);
@@ -0,0 +1,127 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include "platform_hints.h"
+#include "timing.h"
+
+enum class wait_mode {
+    busy_spin,   // Spin with a pause hint forever, lowest wakeup latency, burns a core
+    spin_yield,  // Bounded spin, then yield the time slice, never parks
+    adaptive,    // Bounded spin, bounded yield, then park until notified
+    blocking     // Park straight away
+};
+
+struct wait_config {
+    wait_mode mode{wait_mode::adaptive};
+    int spin_iterations{256};
+    int yield_iterations{16};
+};
+
+// How often each phase ended a wait
+struct wait_stats {
+    uint64_t spin_wakeups{0};
+    uint64_t yield_wakeups{0};
+    uint64_t parks{0};
+};
+
+// Producer-side hook for consumers that never block in wait(), such as a
+// strand on a strand_pool. wake() runs on the producer's thread after each
+// publish and must not block.
+class wakeup_listener {
+public:
+    virtual ~wakeup_listener() = default;
+    virtual void wake() = 0;
+};
+
+// Consumer-side waiting for the channels. The consumer calls wait() with a
+// readiness check; the producer calls notify() after publishing, which only
+// touches the mutex when a consumer is actually parked. Several consumers
+// may wait on one strategy; parked ones are counted so none is missed.
+class wait_strategy {
+public:
+    explicit wait_strategy(const wait_config& config = wait_config{});
+
+    template <typename Ready>
+    void wait(Ready ready, const std::atomic<bool>& running) {
+        wait_until(ready, running, NO_DEADLINE);
+    }
+
+    // Same as wait() but gives up at deadline_ns (a now_ns() timestamp).
+    // Returns whatever ready() last reported.
+    template <typename Ready>
+    bool wait_until(Ready ready, const std::atomic<bool>& running, uint64_t deadline_ns);
+
+    void notify();
+    void notify_all();
+    void set_listener(wakeup_listener* listener) { wake_listener.store(listener, std::memory_order_release); }
+
+    wait_stats stats() const;
+    const wait_config& config() const { return cfg; }
+
+private:
+    bool may_park() const {
+        return cfg.mode == wait_mode::adaptive || cfg.mode == wait_mode::blocking;
+    }
+
+    wait_config cfg;
+    std::atomic<uint32_t> parked{0};  // Consumers parked or about to park
+    std::mutex park_mutex;
+    std::condition_variable park_cv;
+    std::atomic<wakeup_listener*> wake_listener{nullptr};
+
+    std::atomic<uint64_t> spin_wakeups{0};
+    std::atomic<uint64_t> yield_wakeups{0};
+    std::atomic<uint64_t> parks{0};
+};
+
+template <typename Ready>
+bool wait_strategy::wait_until(Ready ready, const std::atomic<bool>& running, uint64_t deadline_ns) {
+    auto expired = [deadline_ns]() {
+        return deadline_ns != NO_DEADLINE && now_ns() >= deadline_ns;
+    };
+
+    if (cfg.mode != wait_mode::blocking) {
+        for (int i = 0; cfg.mode == wait_mode::busy_spin || i < cfg.spin_iterations; ++i) {
+            if (ready() || !running) {
+                spin_wakeups.fetch_add(1, std::memory_order_relaxed);
+                return ready();
+            }
+            if (expired()) {
+                return false;
+            }
+            cpu_relax();
+        }
+        for (int i = 0; cfg.mode == wait_mode::spin_yield || i < cfg.yield_iterations; ++i) {
+            if (ready() || !running) {
+                yield_wakeups.fetch_add(1, std::memory_order_relaxed);
+                return ready();
+            }
+            if (expired()) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(park_mutex);
+    parked.fetch_add(1, std::memory_order_relaxed);
+    // Pairs with the fence in notify(): either ready() sees the producer's
+    // publish or the producer sees parked and takes the lock to notify.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto woken = [&]() { return ready() || !running; };
+    if (deadline_ns == NO_DEADLINE) {
+        park_cv.wait(lock, woken);
+    } else {
+        park_cv.wait_until(lock, to_steady_time(deadline_ns), woken);
+    }
+    parked.fetch_sub(1, std::memory_order_relaxed);
+    parks.fetch_add(1, std::memory_order_relaxed);
+    return ready();
+}
+
+bool parse_wait_mode(const std::string& name, wait_mode& mode);
+const char* wait_mode_name(wait_mode mode);
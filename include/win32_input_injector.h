@@ -0,0 +1,43 @@
+#pragma once
+#include <Windows.h>
+#include <vector>
+#include "i_input_injector.h"
+
+// WM_KEYDOWN/WM_KEYUP lParam for a single key transition
+LPARAM make_key_lparam(uint16_t scan_code, bool extended, bool down);
+// WM_NULL round trip, false when the window is hung or gone
+bool window_responds(HWND window, uint32_t timeout_ms);
+
+class send_message_injector : public i_input_injector {
+public:
+    bool key_down(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) override;
+    bool key_up(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) override;
+    const char* name() const override { return "send_message"; }
+    bool probe(window_handle window) override;
+
+private:
+    bool send(window_handle window, UINT msg, uint16_t vk_code, LPARAM lparam);
+};
+
+class post_message_injector : public i_input_injector {
+public:
+    bool key_down(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) override;
+    bool key_up(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) override;
+    const char* name() const override { return "post_message"; }
+    bool probe(window_handle window) override;
+};
+
+// SendInput only reaches the foreground window, so the target is brought
+// to the front first. Fails when Windows refuses the focus change.
+class send_input_injector : public i_input_injector {
+public:
+    bool key_down(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) override;
+    bool key_up(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) override;
+    const char* name() const override { return "send_input"; }
+    bool probe(window_handle window) override;
+    size_t inject(window_handle window, const key_transition* keys, size_t count) override;
+
+private:
+    bool bring_to_foreground(window_handle window);
+    std::vector<INPUT> inputs;
+};
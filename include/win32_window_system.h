@@ -0,0 +1,48 @@
+#pragma once
+#include <Windows.h>
+#include <atomic>
+#include <future>
+#include <thread>
+#include "i_window_system.h"
+#include "window_event_queue.h"
+
+// Desktop windows through WinEvent hooks. The hooks live on a dedicated
+// message-loop thread, like the keyboard hook, and report shown, destroyed
+// and renamed top-level windows. Only one instance can be active at a time.
+class win32_window_system : public i_window_system {
+public:
+    win32_window_system() = default;
+    ~win32_window_system() override;
+
+    bool start() override;
+    void stop() override;
+    bool next_event(window_event& event, uint64_t deadline_ns) override {
+        return queue.pop(event, deadline_ns);
+    }
+
+    std::vector<window_handle> list_handles() const override;
+    bool describe(window_handle window, window_info& info) const override;
+    std::string window_title(window_handle window) const override;
+    bool is_window(window_handle window) const override;
+
+    bool launch(const std::string& path, const std::vector<std::string>& args,
+                launched_process& process) override;
+    void terminate(launched_process& process) override;
+    void release(launched_process& process) override;
+    uint32_t parent_pid(uint32_t pid) const override;
+    bool post_key(window_handle window, uint16_t vk_code, bool down) override;
+
+    const char* name() const override { return "win32"; }
+
+private:
+    static void CALLBACK event_proc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG object_id,
+                                    LONG child_id, DWORD thread_id, DWORD time);
+    static BOOL CALLBACK enum_proc(HWND handle, LPARAM param);
+    void run(std::promise<bool> installed);
+
+    window_event_queue queue;
+    std::thread hook_thread;
+    std::atomic<DWORD> hook_thread_id{0};
+
+    static std::atomic<win32_window_system*> active;
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "i_window_system.h"
+
+// Hands window events from the thread that observes them to the one that
+// consumes them. Window events are rare, so a plain locked queue will do.
+class window_event_queue {
+public:
+    void push(const window_event& event);
+    bool pop(window_event& event, uint64_t deadline_ns);
+    void open();
+    void close();  // Wakes the consumer, pop() fails until reopened
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<window_event> events;
+    bool accepting{false};
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "i_window_system.h"
+#include "launch_pipeline.h"
+#include "timer_wheel.h"
+#include "title_matcher.h"
+#include "window_registry.h"
+
+// One attached client window the monitor keeps alive
+struct monitored_client {
+    launch_spec spec;       // spec.id and spec.instance are its window_key, the rest is for relaunch
+    int match_id{-1};       // What the title matcher returns for titles of this client
+    bool relaunch{false};   // Start a new client when no matching window turns up
+};
+
+struct health_config {
+    uint32_t sweep_interval_ms{1000};     // Rescan of the desktop covering missed events
+    uint32_t rematch_grace_ms{10000};     // A lost client waits this long for a matching window before relaunch
+    uint32_t relaunch_retry_ms{30000};    // After a relaunch failed
+};
+
+enum class client_health {
+    attached,
+    lost,         // Window died or stopped matching, waiting for a replacement
+    relaunching
+};
+
+// Watches the attached client windows from window events and recovers each
+// one on its own. A client whose window is destroyed, or retitled to
+// something its pattern no longer matches, first takes any unclaimed window
+// that matches it; after rematch_grace_ms without one it is relaunched. The
+// handler is called from the monitor thread with the replacement window and,
+// after a relaunch, the new process. While running, the monitor is the only
+// user of the registry.
+class window_health_monitor {
+public:
+    using reattach_handler = std::function<void(const monitored_client& client, window_handle window,
+                                                const launched_process& process)>;
+
+    window_health_monitor(i_window_system& windows, window_registry& registry, const title_matcher& matcher,
+                          const health_config& config = health_config{})
+        : windows(windows), registry(registry), matcher(matcher), cfg(config), pipeline(windows, registry) {}
+    ~window_health_monitor() { stop(); }
+
+    // Clients must be attached in the registry before start()
+    void add_client(const monitored_client& client);
+    void set_handler(reattach_handler handler) { on_reattach = std::move(handler); }
+    bool start();
+    void stop();
+
+    client_health health(size_t client) const { return clients[client].health.load(std::memory_order_relaxed); }
+    uint64_t losses() const { return loss_count.load(std::memory_order_relaxed); }
+    uint64_t reattaches() const { return reattach_count.load(std::memory_order_relaxed); }
+    uint64_t relaunches() const { return relaunch_count.load(std::memory_order_relaxed); }
+    void print_metrics() const;
+
+private:
+    static constexpr uint64_t TIMER_TICK_NS = 10'000'000;
+    static constexpr size_t SWEEP = SIZE_MAX;  // Timer client index of the sweep
+
+    struct client_state {
+        monitored_client client;
+        size_t index;
+        window_handle window{nullptr};
+        std::atomic<client_health> health{client_health::attached};
+        uint32_t generation{0};    // Bumped on every loss, stale timers compare it
+        uint64_t relaunch_ns{0};   // When a lost client is due for relaunch
+
+        client_state(const monitored_client& client, size_t index) : client(client), index(index) {}
+    };
+
+    struct timer {
+        size_t client;
+        uint32_t generation;
+    };
+
+    void run();
+    void on_event(const window_event& event, uint64_t now);
+    void on_timer(const timer& fired, uint64_t now);
+    void sweep(uint64_t now);
+    void lose(client_state& c, const char* reason, uint64_t now);
+    void offer(window_handle window);          // Gives an unclaimed window to a lost client it matches
+    void offer_all();
+    void reattach(client_state& c, window_handle window, const launched_process& process);
+    void relaunch_due(uint64_t now);  // All due clients in one pipeline run
+    client_state* client_of(window_handle window);
+
+    i_window_system& windows;
+    window_registry& registry;
+    const title_matcher& matcher;
+    health_config cfg;
+    launch_pipeline pipeline;
+    reattach_handler on_reattach;
+    std::deque<client_state> clients;  // Never moved, health is read from other threads
+    timer_wheel<timer> timers{TIMER_TICK_NS};
+    size_t lost_clients{0};
+    std::thread worker;
+    std::atomic<bool> running{false};
+
+    std::atomic<uint64_t> loss_count{0};
+    std::atomic<uint64_t> reattach_count{0};
+    std::atomic<uint64_t> relaunch_count{0};
+};
+
+const char* client_health_name(client_health health);
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "i_window_system.h"
+
+// Changes between two generations of the registry
+struct registry_diff {
+    uint64_t generation{0};
+    std::vector<window_handle> added;     // In z-order
+    std::vector<window_handle> removed;
+    std::vector<window_handle> retitled;
+    bool empty() const { return added.empty() && removed.empty() && retitled.empty(); }
+};
+
+// A client window claimed by one process config instance
+struct window_key {
+    std::string process_id;
+    int instance{0};
+    bool operator==(const window_key& other) const {
+        return instance == other.instance && process_id == other.process_id;
+    }
+};
+
+struct window_key_hash {
+    size_t operator()(const window_key& key) const {
+        return std::hash<std::string>()(key.process_id) * 31 + static_cast<size_t>(key.instance);
+    }
+};
+
+// Known top-level windows indexed by handle, and the client windows indexed
+// by (process id, instance). Kept current by window events; refresh()
+// resynchronises against the desktop. Details are fetched only for windows
+// that are new or reported retitled, so a refresh of an unchanged desktop
+// is one enumeration of handles.
+class window_registry {
+public:
+    explicit window_registry(i_window_system& windows) : windows(windows) {}
+
+    registry_diff refresh();
+    // Applies one event, returns false when it changed nothing
+    bool apply(const window_event& event, registry_diff& diff);
+
+    const window_info* find(window_handle window) const;
+    // Fetches the window's details again on the next refresh, for retitles
+    // whose event may have been missed
+    void mark_dirty(window_handle window);
+    const std::vector<window_handle>& z_order() const { return order; }  // As of the last refresh
+    uint64_t generation() const { return current_generation; }
+    size_t size() const { return by_handle.size(); }
+
+    // A window belongs to at most one key, attaching it again moves it
+    void attach(const window_key& key, window_handle window);
+    void detach(const window_key& key);
+    window_handle attached(const window_key& key) const;
+    const window_key* owner(window_handle window) const;
+
+private:
+    struct entry {
+        window_info info;
+        uint64_t seen{0};      // Generation of the last refresh that saw it
+        bool dirty{false};     // Retitled since its details were fetched
+        const window_key* key{nullptr};  // Points into by_key when attached
+    };
+
+    bool fetch(entry& e);
+    void forget(window_handle window);
+
+    i_window_system& windows;
+    std::unordered_map<window_handle, entry> by_handle;
+    std::unordered_map<window_key, window_handle, window_key_hash> by_key;
+    std::vector<window_handle> order;
+    uint64_t current_generation{0};
+};
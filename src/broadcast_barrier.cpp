@@ -0,0 +1,126 @@
+#include "broadcast_barrier.h"
+#include "timing.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+bool broadcast_barrier::open(uint32_t windows, uint64_t deadline_ns, uint16_t& token) {
+    uint64_t now = now_ns();
+    for (int i = 0; i < SLOTS; ++i) {
+        slot& s = slots[i];
+        // A sender that stopped mid-moment never finishes, its slot goes stale
+        if (s.busy.load(std::memory_order_acquire) &&
+            s.deadline_ns.load(std::memory_order_relaxed) + STALE_NS > now) {
+            continue;
+        }
+        uint64_t state = s.state.load(std::memory_order_acquire);
+        uint16_t generation = static_cast<uint16_t>((field(state, GENERATION_SHIFT) + 1) & GENERATION_MASK);
+        if (generation == 0) {
+            generation = 1;  // Token 0 means unsynchronized
+        }
+        s.injected.store(0, std::memory_order_relaxed);
+        s.first_ns.store(UINT64_MAX, std::memory_order_relaxed);
+        s.last_ns.store(0, std::memory_order_relaxed);
+        s.deadline_ns.store(deadline_ns, std::memory_order_relaxed);
+        uint64_t opened = (uint64_t{generation} << GENERATION_SHIFT) |
+                          (uint64_t{std::min<uint32_t>(windows, FIELD_MASK)} << WINDOWS_SHIFT);
+        if (!s.state.compare_exchange_strong(state, opened, std::memory_order_acq_rel)) {
+            continue;  // A late sender of the stale moment got in first
+        }
+        // The token reaches the senders through a channel, which orders it after this
+        s.busy.store(true, std::memory_order_release);
+        token = static_cast<uint16_t>((generation << SLOT_BITS) | i);
+        return true;
+    }
+    exhausted_count.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+template <typename Change>
+bool broadcast_barrier::update(uint16_t token, Change change) {
+    slot& s = slots[token & (SLOTS - 1)];
+    uint64_t state = s.state.load(std::memory_order_acquire);
+    uint64_t next;
+    do {
+        if (field(state, GENERATION_SHIFT) != uint64_t{token} >> SLOT_BITS || complete(state)) {
+            return false;  // Reclaimed, the moment is long over
+        }
+        next = change(state);
+    } while (!s.state.compare_exchange_weak(state, next, std::memory_order_acq_rel));
+
+    // Exactly one update completes the moment
+    if (complete(next)) {
+        if (s.injected.load() >= 2) {
+            skew.record(s.last_ns.load() - s.first_ns.load());
+        }
+        s.busy.store(false, std::memory_order_release);
+    }
+    return true;
+}
+
+void broadcast_barrier::withdraw(uint16_t token, uint32_t windows) {
+    if (windows == 0) {
+        return;
+    }
+    update(token, [windows](uint64_t state) {
+        uint64_t withdrawn = std::min<uint64_t>(windows, field(state, WINDOWS_SHIFT));
+        return state - (withdrawn << WINDOWS_SHIFT);
+    });
+}
+
+bool broadcast_barrier::arrive_and_wait(uint16_t token) {
+    if (!update(token, [](uint64_t state) { return state + (uint64_t{1} << ARRIVED_SHIFT); })) {
+        return false;
+    }
+    slot& s = slots[token & (SLOTS - 1)];
+    uint64_t deadline_ns = s.deadline_ns.load(std::memory_order_relaxed);
+    // Withdrawn windows lower the count while we spin. Past a short spin the
+    // time slice is given up, a window still on its way may need this core.
+    for (int spins = 0;; ++spins) {
+        uint64_t state = s.state.load(std::memory_order_acquire);
+        if (field(state, GENERATION_SHIFT) != uint64_t{token} >> SLOT_BITS) {
+            return false;
+        }
+        if (field(state, ARRIVED_SHIFT) >= field(state, WINDOWS_SHIFT)) {
+            return true;
+        }
+        if (now_ns() >= deadline_ns) {
+            timeout_count.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (spins < SPIN_ITERATIONS) {
+            cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void broadcast_barrier::finish(uint16_t token, uint64_t injected_ns) {
+    slot& s = slots[token & (SLOTS - 1)];
+    // Recorded before the moment can complete and report its skew
+    if (injected_ns != 0 && field(s.state.load(std::memory_order_acquire), GENERATION_SHIFT) ==
+                                uint64_t{token} >> SLOT_BITS) {
+        uint64_t first = s.first_ns.load(std::memory_order_relaxed);
+        while (injected_ns < first && !s.first_ns.compare_exchange_weak(first, injected_ns)) {}
+        uint64_t last = s.last_ns.load(std::memory_order_relaxed);
+        while (injected_ns > last && !s.last_ns.compare_exchange_weak(last, injected_ns)) {}
+        s.injected.fetch_add(1);
+    }
+    update(token, [](uint64_t state) { return state + 1; });
+}
+
+void broadcast_barrier::skip(uint16_t token) {
+    update(token, [](uint64_t state) { return state + (uint64_t{1} << ARRIVED_SHIFT) + 1; });
+}
+
+void broadcast_barrier::print_metrics() const {
+    if (skew.count() == 0 && timeouts() == 0) {
+        return;
+    }
+    std::cout << "Synchronous Broadcast Metrics:"
+              << " Barrier Timeouts: " << timeouts()
+              << " Slots Exhausted: " << exhausted_count.load(std::memory_order_relaxed)
+              << std::endl;
+    skew.print(std::cout, "first->last window");
+}
@@ -0,0 +1,310 @@
+#include "broadcast_channel.h"
+#include <algorithm>
+
+broadcast_ring::broadcast_ring(size_t capacity, const wait_config& wait)
+    : mask(round_up_pow2(capacity) - 1)
+    , entries(new entry[mask + 1]) {
+    readers.reserve(MAX_READERS);
+    for (int i = 0; i < MAX_READERS; ++i) {
+        readers.push_back(std::make_unique<reader_slot>(wait));
+    }
+}
+
+int broadcast_ring::add_reader() {
+    int count = reader_count.load(std::memory_order_relaxed);
+    int reader = 0;
+    while (reader < count && readers[reader]->active.load(std::memory_order_relaxed)) {
+        ++reader;
+    }
+    if (reader >= MAX_READERS) {
+        return -1;
+    }
+    // New readers only see what is published after they join
+    auto& slot = *readers[reader];
+    addressed_end[reader] = 0;
+    slot.cursor.store(published.load(std::memory_order_acquire), std::memory_order_relaxed);
+    slot.scan.store(NOT_SCANNING, std::memory_order_relaxed);
+    slot.active.store(true, std::memory_order_release);
+    reader_count.store(std::max(count, reader + 1), std::memory_order_release);
+    return reader;
+}
+
+void broadcast_ring::remove_reader(int reader) {
+    auto& slot = *readers[reader];
+    slot.waiter.set_listener(nullptr);
+    slot.active.store(false, std::memory_order_release);
+    slot.waiter.notify_all();
+}
+
+uint64_t broadcast_ring::min_reader_cursor(uint64_t seq) const {
+    // The scan is loaded before the cursor, see begin_scan()
+    uint64_t min_cursor = seq;
+    int count = reader_count.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        const auto& slot = *readers[i];
+        if (!slot.active.load(std::memory_order_acquire)) {
+            continue;
+        }
+        min_cursor = std::min(min_cursor, slot.scan.load(std::memory_order_seq_cst));
+        min_cursor = std::min(min_cursor, slot.cursor.load(std::memory_order_seq_cst));
+    }
+    return min_cursor;
+}
+
+bool broadcast_ring::reserve(uint64_t seq, size_t count) {
+    if (seq + count - cached_min_cursor <= capacity()) {
+        return true;
+    }
+    cached_min_cursor = min_reader_cursor(seq);
+    if (seq + count - cached_min_cursor <= capacity()) {
+        return true;
+    }
+    // Readers that were not addressed lately may be holding the ring
+    advance_idle_readers(seq);
+    cached_min_cursor = min_reader_cursor(seq);
+    return seq + count - cached_min_cursor <= capacity();
+}
+
+void broadcast_ring::advance_idle_readers(uint64_t seq) {
+    int count = reader_count.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        // Nothing at or after the cursor is addressed to this reader. A
+        // failed exchange means it moved on its own, which is checked again.
+        // A scan still running keeps its entries through min_reader_cursor().
+        auto& cursor = readers[i]->cursor;
+        uint64_t current = cursor.load(std::memory_order_acquire);
+        while (current < seq && current >= addressed_end[i] &&
+               !cursor.compare_exchange_weak(current, seq, std::memory_order_seq_cst)) {
+        }
+    }
+}
+
+void broadcast_ring::mark_addressed(uint64_t target_mask, uint64_t end) {
+    for (uint64_t bits = target_mask; bits != 0; bits &= bits - 1) {
+        addressed_end[lowest_bit(bits)] = end;
+    }
+}
+
+bool broadcast_ring::publish(const message& msg, uint64_t target_mask) {
+    uint64_t seq = published.load(std::memory_order_relaxed);
+    if (!reserve(seq, 1)) {
+        return false;
+    }
+    write_entry(seq, msg, target_mask);
+    mark_addressed(target_mask, seq + 1);
+    published.store(seq + 1, std::memory_order_release);
+    notify_readers(target_mask);
+    return true;
+}
+
+bool broadcast_ring::publish_batch(const std::vector<message>& messages, uint64_t target_mask) {
+    if (messages.empty()) {
+        return true;
+    }
+    uint64_t seq = published.load(std::memory_order_relaxed);
+    if (!reserve(seq, messages.size())) {
+        return false;
+    }
+    for (const auto& msg : messages) {
+        write_entry(seq++, msg, target_mask);
+    }
+    mark_addressed(target_mask, seq);
+    published.store(seq, std::memory_order_release);
+    notify_readers(target_mask);
+    return true;
+}
+
+void broadcast_ring::write_entry(uint64_t seq, const message& msg, uint64_t target_mask) {
+    // Published by the release store of published
+    entry& e = entries[seq & mask];
+    e.msg = msg;
+    e.target_mask.store(target_mask, std::memory_order_relaxed);
+}
+
+bool broadcast_ring::push(const message& msg, uint64_t target_mask) {
+    bool pushed = overflow.push([&]() { return publish(msg, target_mask); },
+                                [&]() { return newest_pending(msg, target_mask); },
+                                []() { return false; });
+    if (pushed) {
+        record_fill(published.load(std::memory_order_relaxed));
+    }
+    return pushed;
+}
+
+bool broadcast_ring::newest_pending(const message& msg, uint64_t target_mask) const {
+    // Entries are only rewritten by this writer, readers merely copy them
+    uint64_t seq = published.load(std::memory_order_relaxed);
+    if (seq == 0) {
+        return false;
+    }
+    const entry& newest = entries[(seq - 1) & mask];
+    if ((newest.target_mask.load(std::memory_order_relaxed) & target_mask) != target_mask ||
+        !coalescible(newest.msg, msg)) {
+        return false;
+    }
+    for (uint64_t bits = target_mask; bits != 0; bits &= bits - 1) {
+        if (readers[lowest_bit(bits)]->cursor.load(std::memory_order_acquire) >= seq) {
+            return false;  // Already read by this reader
+        }
+    }
+    return true;
+}
+
+void broadcast_ring::record_fill(uint64_t seq) {
+    // The cached cursor only overestimates the fill, refresh it before a
+    // new high-water mark is taken
+    if (seq - cached_min_cursor > overflow.high_water_mark()) {
+        cached_min_cursor = min_reader_cursor(seq);
+        overflow.record_size(static_cast<size_t>(seq - cached_min_cursor));
+    }
+}
+
+void broadcast_ring::notify_readers(uint64_t target_mask) {
+    int count = reader_count.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        if ((target_mask & (uint64_t{1} << i)) && readers[i]->active.load(std::memory_order_relaxed)) {
+            readers[i]->waiter.notify();
+        }
+    }
+}
+
+uint64_t broadcast_ring::begin_scan(reader_slot& slot) {
+    // Announce the scan, then check the cursor was not moved meanwhile. The
+    // writer moves cursors before it loads the scans, so either it sees the
+    // scan and keeps its entries, or the scan starts from the moved cursor.
+    uint64_t cursor = slot.cursor.load(std::memory_order_acquire);
+    while (true) {
+        slot.scan.store(cursor, std::memory_order_seq_cst);
+        uint64_t current = slot.cursor.load(std::memory_order_seq_cst);
+        if (current == cursor) {
+            return cursor;
+        }
+        cursor = current;
+    }
+}
+
+bool broadcast_ring::skip_to_addressed(int reader) {
+    auto& slot = *readers[reader];
+    uint64_t bit = uint64_t{1} << reader;
+    uint64_t cursor = begin_scan(slot);
+    while (true) {
+        uint64_t end = published.load(std::memory_order_acquire);
+        uint64_t next = cursor;
+        while (next < end && !(entries[next & mask].target_mask.load(std::memory_order_relaxed) & bit)) {
+            ++next;
+        }
+        // On failure the writer moved this reader past what it was skipping
+        if (next == cursor || slot.cursor.compare_exchange_strong(cursor, next, std::memory_order_acq_rel)) {
+            end_scan(slot);
+            return next < end;
+        }
+        cursor = begin_scan(slot);
+    }
+}
+
+bool broadcast_ring::try_read(int reader, message& msg) {
+    auto& slot = *readers[reader];
+    while (skip_to_addressed(reader)) {
+        uint64_t cursor = begin_scan(slot);
+        const entry& e = entries[cursor & mask];
+        bool addressed = cursor < published.load(std::memory_order_acquire) &&
+                         (e.target_mask.load(std::memory_order_relaxed) & (uint64_t{1} << reader));
+        if (addressed) {
+            msg = e.msg;
+        }
+        // The entry was only ours to read if the writer did not move us meanwhile
+        bool committed = addressed && slot.cursor.compare_exchange_strong(cursor, cursor + 1,
+                                                                           std::memory_order_acq_rel);
+        end_scan(slot);
+        if (committed) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t broadcast_ring::try_read_batch(int reader, std::vector<message>& out, size_t max_messages) {
+    auto& slot = *readers[reader];
+    uint64_t bit = uint64_t{1} << reader;
+    size_t first = out.size();
+    while (true) {
+        uint64_t start = begin_scan(slot);
+        uint64_t cursor = start;
+        uint64_t end = published.load(std::memory_order_acquire);
+        while (cursor < end && out.size() - first < max_messages) {
+            const entry& e = entries[cursor & mask];
+            if (e.target_mask.load(std::memory_order_relaxed) & bit) {
+                out.push_back(e.msg);
+            }
+            ++cursor;
+        }
+        bool committed = cursor == start ||
+                         slot.cursor.compare_exchange_strong(start, cursor, std::memory_order_acq_rel);
+        end_scan(slot);
+        if (committed) {
+            return out.size() - first;
+        }
+        out.resize(first);
+    }
+}
+
+void broadcast_ring::wait(int reader, const std::atomic<bool>& running) {
+    readers[reader]->waiter.wait([this, reader]() { return skip_to_addressed(reader); }, running);
+}
+
+bool broadcast_ring::wait_until(int reader, const std::atomic<bool>& running, uint64_t deadline_ns) {
+    return readers[reader]->waiter.wait_until([this, reader]() { return skip_to_addressed(reader); },
+                                              running, deadline_ns);
+}
+
+void broadcast_ring::wake_all() {
+    int count = reader_count.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        readers[i]->waiter.notify_all();
+    }
+}
+
+size_t broadcast_ring::pending(int reader) const {
+    uint64_t cursor = readers[reader]->cursor.load(std::memory_order_acquire);
+    uint64_t end = published.load(std::memory_order_acquire);
+    return static_cast<size_t>(end - cursor);
+}
+
+broadcast_channel::broadcast_channel(std::shared_ptr<broadcast_ring> ring, int reader)
+    : shared_ring(std::move(ring)), reader(reader) {}
+
+broadcast_channel::~broadcast_channel() {
+    shared_ring->remove_reader(reader);
+}
+
+bool broadcast_channel::try_push(const message& msg) {
+    return shared_ring->publish(msg, reader_mask());
+}
+
+bool broadcast_channel::try_push_batch(const std::vector<message>& messages) {
+    return shared_ring->publish_batch(messages, reader_mask());
+}
+
+bool broadcast_channel::try_pop(message& msg) {
+    return shared_ring->try_read(reader, msg);
+}
+
+size_t broadcast_channel::try_pop_batch(std::vector<message>& out, size_t max_messages) {
+    return shared_ring->try_read_batch(reader, out, max_messages);
+}
+
+void broadcast_channel::wait_for_messages(const std::atomic<bool>& running) {
+    shared_ring->wait(reader, running);
+}
+
+bool broadcast_channel::wait_for_messages_until(const std::atomic<bool>& running, uint64_t deadline_ns) {
+    return shared_ring->wait_until(reader, running, deadline_ns);
+}
+
+void broadcast_channel::wake_all() {
+    shared_ring->wake_all();
+}
+
+size_t broadcast_channel::size() const {
+    return shared_ring->pending(reader);
+}
@@ -0,0 +1,83 @@
+#include "circuit_breaker.h"
+#include "timing.h"
+#include <algorithm>
+
+circuit_breaker::circuit_breaker(const breaker_config& config)
+    : cfg(config)
+    , probe_interval_ns(uint64_t{config.probe_interval_ms} * 1'000'000) {}
+
+void circuit_breaker::record_success() {
+    consecutive_failures = 0;
+    if (current() != breaker_state::closed) {
+        recovery_count.fetch_add(1, std::memory_order_relaxed);
+        probe_interval_ns = uint64_t{cfg.probe_interval_ms} * 1'000'000;
+        state.store(breaker_state::closed, std::memory_order_relaxed);
+    }
+}
+
+bool circuit_breaker::record_failure(uint64_t now_ns) {
+    switch (current()) {
+        case breaker_state::half_open:
+            // Still unhealthy, back off further
+            probe_interval_ns = std::min(probe_interval_ns * 2, uint64_t{cfg.max_probe_interval_ms} * 1'000'000);
+            open_at(now_ns);
+            return false;
+        case breaker_state::open:
+            return false;
+        case breaker_state::closed:
+        default:
+            if (++consecutive_failures < std::max(cfg.failure_threshold, 1u)) {
+                return false;
+            }
+            trip_count.fetch_add(1, std::memory_order_relaxed);
+            open_at(now_ns);
+            return true;
+    }
+}
+
+bool circuit_breaker::probe_due(uint64_t now_ns) const {
+    return current() == breaker_state::open && now_ns >= probe_at_ns;
+}
+
+uint64_t circuit_breaker::next_probe_ns() const {
+    return current() == breaker_state::open ? probe_at_ns : NO_DEADLINE;
+}
+
+void circuit_breaker::begin_probe() {
+    probe_count.fetch_add(1, std::memory_order_relaxed);
+    state.store(breaker_state::half_open, std::memory_order_relaxed);
+}
+
+void circuit_breaker::open_at(uint64_t now_ns) {
+    consecutive_failures = 0;
+    probe_at_ns = now_ns + probe_interval_ns;
+    state.store(breaker_state::open, std::memory_order_relaxed);
+}
+
+const char* breaker_state_name(breaker_state state) {
+    switch (state) {
+        case breaker_state::open: return "open";
+        case breaker_state::half_open: return "half_open";
+        case breaker_state::closed:
+        default: return "closed";
+    }
+}
+
+bool parse_open_policy(const std::string& name, open_policy& policy) {
+    if (name == "drop") {
+        policy = open_policy::drop;
+    } else if (name == "park") {
+        policy = open_policy::park;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* open_policy_name(open_policy policy) {
+    switch (policy) {
+        case open_policy::park: return "park";
+        case open_policy::drop:
+        default: return "drop";
+    }
+}
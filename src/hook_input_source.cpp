@@ -0,0 +1,84 @@
+#include "hook_input_source.h"
+#include "logger.h"
+#include "timing.h"
+
+std::atomic<hook_input_source*> hook_input_source::active{nullptr};
+
+hook_input_source::~hook_input_source() {
+    stop();
+}
+
+bool hook_input_source::start() {
+    hook_input_source* expected = nullptr;
+    if (!active.compare_exchange_strong(expected, this)) {
+        LOG_ERROR("A keyboard hook is already installed");
+        return false;
+    }
+
+    queue.open();
+    std::promise<bool> installed;
+    auto result = installed.get_future();
+    hook_thread = std::thread(&hook_input_source::run, this, std::move(installed));
+    if (!result.get()) {
+        hook_thread.join();
+        queue.close();
+        active = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void hook_input_source::stop() {
+    queue.close();
+    if (hook_thread.joinable()) {
+        PostThreadMessageW(hook_thread_id, WM_QUIT, 0, 0);
+        hook_thread.join();
+    }
+    hook_input_source* self = this;
+    active.compare_exchange_strong(self, nullptr);
+}
+
+void hook_input_source::run(std::promise<bool> installed) {
+    // Low-level hooks are called on this thread; a slow thread delays every
+    // keystroke on the desktop, so keep it ahead of normal work.
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+
+    // Make sure the thread has a message queue before stop() can post to it
+    MSG msg;
+    PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    hook_thread_id = GetCurrentThreadId();
+
+    HHOOK hook = SetWindowsHookExW(WH_KEYBOARD_LL, &hook_input_source::hook_proc,
+                                   GetModuleHandleW(nullptr), 0);
+    if (!hook) {
+        LOG_ERROR("SetWindowsHookEx failed, error {}", GetLastError());
+        installed.set_value(false);
+        return;
+    }
+    installed.set_value(true);
+    LOG_INFO("Low-level keyboard hook installed");
+
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+        TranslateMessage(&msg);
+        DispatchMessageW(&msg);
+    }
+    UnhookWindowsHookEx(hook);
+}
+
+LRESULT CALLBACK hook_input_source::hook_proc(int code, WPARAM wparam, LPARAM lparam) {
+    if (code == HC_ACTION) {
+        const auto* info = reinterpret_cast<const KBDLLHOOKSTRUCT*>(lparam);
+        hook_input_source* self = active.load(std::memory_order_acquire);
+        // Injected input is our own output, never treat it as a trigger
+        if (self && !(info->flags & LLKHF_INJECTED) && info->vkCode < 256) {
+            input_event event;
+            event.vk_code = static_cast<uint16_t>(info->vkCode);
+            event.scan_code = static_cast<uint16_t>(info->scanCode);
+            event.key_down = wparam == WM_KEYDOWN || wparam == WM_SYSKEYDOWN;
+            event.extended = (info->flags & LLKHF_EXTENDED) != 0;
+            event.timestamp_ns = now_ns();
+            self->queue.push(event);
+        }
+    }
+    return CallNextHookEx(nullptr, code, wparam, lparam);
+}
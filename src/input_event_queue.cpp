@@ -0,0 +1,36 @@
+#include "input_event_queue.h"
+
+input_event_queue::input_event_queue(const wait_config& wait)
+    : waiter(wait) {}
+
+bool input_event_queue::push(const input_event& event) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) >= CAPACITY) {
+        dropped_events.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    slots[t % CAPACITY] = event;
+    tail.store(t + 1, std::memory_order_release);
+    waiter.notify();
+    return true;
+}
+
+bool input_event_queue::pop(input_event& event, uint64_t deadline_ns) {
+    size_t h = head.load(std::memory_order_relaxed);
+    auto ready = [&]() { return tail.load(std::memory_order_acquire) != h; };
+    if (!ready() && !waiter.wait_until(ready, accepting, deadline_ns)) {
+        return false;
+    }
+    event = slots[h % CAPACITY];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+void input_event_queue::open() {
+    accepting = true;
+}
+
+void input_event_queue::close() {
+    accepting = false;
+    waiter.notify_all();
+}
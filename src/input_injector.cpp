@@ -0,0 +1,26 @@
+#include "i_input_injector.h"
+
+bool parse_injector_type(const std::string& name, injector_type& type) {
+    if (name == "send_message") {
+        type = injector_type::send_message;
+    } else if (name == "post_message") {
+        type = injector_type::post_message;
+    } else if (name == "send_input") {
+        type = injector_type::send_input;
+    } else if (name == "recording") {
+        type = injector_type::recording;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* injector_type_name(injector_type type) {
+    switch (type) {
+        case injector_type::post_message: return "post_message";
+        case injector_type::send_input: return "send_input";
+        case injector_type::recording: return "recording";
+        case injector_type::send_message:
+        default: return "send_message";
+    }
+}
@@ -0,0 +1,114 @@
+#include "input_router.h"
+#include "broadcast_channel.h"
+#include "platform_hints.h"
+
+int input_router::add_target(int process_index, int instance, std::shared_ptr<message_channel> channel) {
+    std::lock_guard<std::mutex> lock(targets_mutex);
+    if (target_count >= MAX_TARGETS) {
+        return -1;
+    }
+    int id = target_count++;
+    target_slot& slot = targets[id];
+    slot.selector = target_selector{process_index, instance};
+    if (auto* view = dynamic_cast<broadcast_channel*>(channel.get())) {
+        slot.ring = &view->ring();
+        slot.reader_mask = view->reader_mask();
+    }
+    slot.channel = std::move(channel);
+    active.fetch_or(uint64_t{1} << id, std::memory_order_release);
+    return id;
+}
+
+void input_router::remove_target(int id) {
+    if (id >= 0 && id < MAX_TARGETS) {
+        active.fetch_and(~(uint64_t{1} << id), std::memory_order_release);
+    }
+}
+
+void input_router::clear() {
+    std::lock_guard<std::mutex> lock(targets_mutex);
+    active.store(0, std::memory_order_release);
+    for (int id = 0; id < target_count; ++id) {
+        targets[id] = target_slot{};
+    }
+    target_count = 0;
+}
+
+int input_router::find_target(int process_index, int instance) const {
+    uint64_t mask = active_targets();
+    for (uint64_t bits = mask; bits != 0; bits &= bits - 1) {
+        int id = lowest_bit(bits);
+        if (targets[id].selector.process_index == process_index && targets[id].selector.instance == instance) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+uint64_t input_router::resolve(const target_selector& selector) const {
+    uint64_t mask = 0;
+    uint64_t candidates = active_targets();
+    for (uint64_t bits = candidates; bits != 0; bits &= bits - 1) {
+        int id = lowest_bit(bits);
+        const target_selector& target = targets[id].selector;
+        if ((selector.process_index == -1 || selector.process_index == target.process_index) &&
+            (selector.instance == -1 || selector.instance == target.instance)) {
+            mask |= uint64_t{1} << id;
+        }
+    }
+    return mask;
+}
+
+uint64_t input_router::resolve(const std::vector<target_selector>& selectors) const {
+    uint64_t mask = 0;
+    for (const auto& selector : selectors) {
+        mask |= resolve(selector);
+    }
+    return mask;
+}
+
+std::shared_ptr<message_channel> input_router::channel(int id) const {
+    std::lock_guard<std::mutex> lock(targets_mutex);
+    return id >= 0 && id < target_count ? targets[id].channel : nullptr;
+}
+
+uint64_t input_router::fan_out(const message& msg, uint64_t mask) {
+    mask &= active_targets();
+    uint64_t reached = 0;
+    // Targets on a shared ring are collected and reached with one publish
+    broadcast_ring* ring = nullptr;
+    uint64_t ring_readers = 0;
+    uint64_t ring_targets = 0;
+    auto publish_ring = [&]() {
+        if (ring && ring->push(msg, ring_readers)) {
+            reached |= ring_targets;
+        }
+        ring_readers = 0;
+        ring_targets = 0;
+    };
+
+    for (uint64_t bits = mask; bits != 0; bits &= bits - 1) {
+        int id = lowest_bit(bits);
+        uint64_t bit = uint64_t{1} << id;
+        const target_slot& slot = targets[id];
+        if (slot.ring) {
+            if (ring != slot.ring) {
+                publish_ring();
+                ring = slot.ring;
+            }
+            ring_readers |= slot.reader_mask;
+            ring_targets |= bit;
+        } else if (slot.channel->push(msg)) {
+            reached |= bit;
+        }
+    }
+    publish_ring();
+    return reached;
+}
+
+void input_router::wake_all() {
+    uint64_t mask = active_targets();
+    for (uint64_t bits = mask; bits != 0; bits &= bits - 1) {
+        targets[lowest_bit(bits)].channel->wake_all();
+    }
+}
@@ -1,6 +1,14 @@
 #include "input_sender_context.h"
+#include "key_codes.h"
+#include "settings_manager.h"
+#include "timing.h"
+#include "logger.h"
+#include "timing_service.h"
+#include "win32_input_injector.h"
+#include "recording_injector.h"
+#include "broadcast_channel.h"
+#include <algorithm>
 #include <iostream>
-#include <sstream>
 
 input_sender_context::input_sender_context(std::shared_ptr<message_channel> outbound_channel,
                                          std::shared_ptr<message_channel> inbound_channel,
@@ -15,202 +23,392 @@ input_sender_context::input_sender_context(std::shared_ptr<message_channel> outb
     , msg_receiver(inbound_channel, running)
     , target_hwnd(target_window)
     , process_id(process_id)
-    , instance_number(instance_num) {
-    std::cout << "Input sender context created for window handle: 0x" 
-              << std::hex << (uintptr_t)target_window << std::dec
-              << " (Process: " << process_id << ", Instance: " << instance_num << ")" 
-              << std::endl;
+    , process_index(SettingsManager::getInstance().findProcessIndex(process_id))
+    , instance_number(instance_num)
+    , injector(create_injector(process_id))
+    , breaker(load_breaker_config(process_id))
+    , shares_ring(dynamic_cast<broadcast_channel*>(inbound_channel.get()) != nullptr) {
+    batch.reserve(MAX_BURST);
+    injector->set_timeout(breaker.config().timeout_ms);
+    LOG_INFO("Input sender context created for window handle: 0x{} (Process: {}, Instance: {}, Injector: {})",
+             target_window, process_id, instance_num, injector->name());
 }
 
 void input_sender_context::operator()() {
-    std::cout << context_name << " thread started" << std::endl;
-    uint32_t last_processed_id = 0;  // Track message IDs 
+    LOG_INFO("{} thread started", context_name);
 
     while (running) {
-        auto msg = msg_receiver.receive_message();  
-        if (msg) {
-            std::cout << "\n" << context_name << " received message ID: " << msg->m_msg_id 
-                      << " (Last processed: " << last_processed_id << ")" << std::endl;
-
-            if ((msg->target_process_id == process_id) && 
-                (msg->target_instance == -1 || msg->target_instance == instance_number)) {
-                
-                process_message(*msg);
-                last_processed_id = msg->m_msg_id;
-            }
+        adopt_window();
+        probe_if_due();
+        // Wake for the next key-up or probe as well as for new messages,
+        // then take everything pending in one go
+        uint64_t wake_ns = std::min(key_releases.next_deadline(), breaker.next_probe_ns());
+        uint64_t poll_ns = std::min(wake_ns, now_ns() + PARK_POLL_NS);
+        if (parked() && shares_ring) {
+            batch.clear();
+            stash_parked(msg_receiver.receive_batch_until(batch, MAX_BURST, poll_ns));
+            continue;
+        }
+        if (parked()) {
+            // Messages stay queued until the window recovers
+            std::this_thread::sleep_until(to_steady_time(poll_ns));
+            continue;
+        }
+        if (take_backlog()) {
+            handle_batch();
+            continue;
         }
+        batch.clear();
+        if (msg_receiver.receive_batch_until(batch, MAX_BURST, timing.coarse_deadline(wake_ns)) > 0) {
+            handle_batch();
+        }
+        release_due_keys(true);
     }
+    release_all_keys();
 }
 
-void input_sender_context::process_message(const message& msg) {
-    // Get window title for logging
-    char window_title[256];
-    GetWindowTextA(target_hwnd, window_title, sizeof(window_title));
-    
-    std::cout << "\nStarting to process key in " << context_name << " (Message ID: " << msg.m_msg_id << "):\n"
-              << "  Key: " << msg.m_msg << "\n"
-              << "  Target Window: 0x" << std::hex << (uintptr_t)target_hwnd << std::dec << "\n"
-              << "  Window Title: " << window_title << "\n";
-
-    messages_processed++;
-
-    if (msg.m_command == 2) {  // Command 2 is for key press events
-        size_t prefix_len = strlen("Key pressed: ");
-        if (msg.m_msg.length() > prefix_len) {
-            std::string key_name = msg.m_msg.substr(prefix_len);
-            std::cout << "  Sending key '" << key_name << "' to window\n";
-            
-            auto start_time = std::chrono::high_resolution_clock::now();
-            send_key_to_window(key_name);
-            auto end_time = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-            
-            std::cout << "Finished processing Message ID: " << msg.m_msg_id 
-                      << " (took " << duration.count() << "ms)" << std::endl;
+uint64_t input_sender_context::run_once() {
+    adopt_window();
+    probe_if_due();
+    batch.clear();
+    if (parked() && shares_ring) {
+        stash_parked(inbound_channel->try_pop_batch(batch, MAX_BURST));
+    } else if (!parked() && (take_backlog() || inbound_channel->try_pop_batch(batch, MAX_BURST) > 0)) {
+        handle_batch();
+        if (batch.size() == MAX_BURST || !parked_backlog.empty()) {
+            worker_strand->wake();  // More may be queued, let other windows go first
         }
     }
+    // The pool runs us at the deadline itself, no need to spin for it
+    release_due_keys(false);
+    return std::min(key_releases.next_deadline(), breaker.next_probe_ns());
 }
 
-void input_sender_context::send_key_to_window(const std::string& key_name) {
-    WORD vk_code = get_virtual_key_code(key_name);
-    if (vk_code != 0) {
-        std::cout << "Sending key: " << key_name 
-                  << " (VK: 0x" << std::hex << vk_code << std::dec << ")"
-                  << " to window: 0x" << std::hex << (uintptr_t)target_hwnd << std::dec << std::endl;
+void input_sender_context::handle_batch() {
+    dequeue_ns = now_ns();
+    LOG_DEBUG("{} received {} messages (first ID: {})", context_name, batch.size(), batch.front().m_msg_id);
+    process_batch(batch.data(), batch.size());
+}
+
+void input_sender_context::process_message(const message& msg) {
+    dequeue_ns = now_ns();
+    process_batch(&msg, 1);
+}
+
+void input_sender_context::process_batch(const message* messages, size_t count) {
+    adopt_window();
+    if (logger::get_instance().enabled(log_level::trace)) {
+        // Window title only for tracing, it costs a cross-process call
+        char window_title[256];
+        GetWindowTextA(target_hwnd, window_title, sizeof(window_title));
+        LOG_TRACE("{} processing {} messages for window 0x{} ({})",
+                  context_name, count, target_hwnd, window_title);
+    }
 
-        if (!IsWindow(target_hwnd)) {
-            std::cout << "ERROR: Target window is not valid!" << std::endl;
-            return;
+    // Every ready key goes down in one burst, in channel order. Keys of a
+    // synchronous moment get a burst of their own, injected at the barrier.
+    burst_messages.clear();
+    uint16_t burst_token = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const message& msg = messages[i];
+        // target_process -1 means the message was routed by a broadcast mask
+        if ((msg.target_process != -1 && msg.target_process != process_index) ||
+            (msg.target_instance != -1 && msg.target_instance != instance_number)) {
+            continue;
         }
+        messages_processed++;
+        if (msg.m_command != message_command::key_press || msg.vk_code == 0) {
+            continue;
+        }
+        uint16_t token = (msg.m_flags & KEY_FLAG_SYNC) ? msg.sync_token : 0;
+        if (token != burst_token) {
+            inject_burst(burst_token);
+            burst_token = token;
+        }
+        queue_key_down(msg.vk_code, msg.scan_code, (msg.m_flags & KEY_FLAG_EXTENDED) != 0);
+        burst_messages.push_back(&msg);
+    }
+    inject_burst(burst_token);
+}
+
+void input_sender_context::inject_burst(uint16_t sync_token) {
+    if (burst_messages.empty()) {
+        return;
+    }
+    // Only the first burst of a moment meets the other windows, keys of the
+    // same moment that arrive later just follow
+    bool rendezvous = sync_token != 0 && sync_token != last_sync_token;
+    if (rendezvous) {
+        last_sync_token = sync_token;
+    }
+
+    if (!breaker.closed()) {
+        messages_dropped += burst_messages.size();
+        discard_burst(rendezvous ? sync_token : 0);
+        return;
+    }
+    if (!IsWindow(target_hwnd)) {
+        LOG_ERROR("{}: target window 0x{} is not valid", context_name, target_hwnd);
+        discard_burst(rendezvous ? sync_token : 0);
+        return;
+    }
+
+    if (rendezvous && !barrier.arrive_and_wait(sync_token)) {
+        LOG_WARN("{} timed out waiting for the other windows of a synchronous broadcast", context_name);
+    }
+
+    uint64_t inject_start_ns = now_ns();
+    size_t injected = flush_burst();
+    uint64_t inject_end_ns = now_ns();
+    if (rendezvous) {
+        barrier.finish(sync_token, injected > 0 ? inject_start_ns : 0);
+    }
 
-        simulate_key_press(vk_code);
+    for (const message* msg : burst_messages) {
+        const held_key& key = held_keys[msg->vk_code & 0xFF];
+        if (!key.down) {
+            continue;  // Its key down was not delivered
+        }
+        // The key-up is only scheduled, later keys can go down right away
+        schedule_release(msg->vk_code, inject_end_ns + uint64_t{msg->hold_us} * 1000);
         inputs_sent++;
+        latency.detect_to_enqueue.record(msg->enqueue_ns - msg->timestamp_ns);
+        latency.enqueue_to_dequeue.record(dequeue_ns - msg->enqueue_ns);
+        latency.dequeue_to_inject.record(inject_start_ns - dequeue_ns);
+        latency.injection.record(inject_end_ns - inject_start_ns);
+        latency.end_to_end.record(inject_end_ns - msg->timestamp_ns);
     }
-}
 
+    LOG_DEBUG("Injected burst of {} transitions for {} messages (took {}us, {}us since first detection)",
+              injected, burst_messages.size(), (inject_end_ns - inject_start_ns) / 1000,
+              (inject_end_ns - burst_messages.front()->timestamp_ns) / 1000);
+    burst_messages.clear();
+}
 
+void input_sender_context::simulate_key_combination(const std::vector<WORD>& vk_codes, uint64_t hold_ns) {
+    LOG_DEBUG("Simulating key combination of {} keys", vk_codes.size());
 
-void input_sender_context::simulate_key_press(WORD vk_code) {
-    UINT scan_code;
-    if ((vk_code >= 'A' && vk_code <= 'Z') || (vk_code >= '0' && vk_code <= '9')) {
-        scan_code = MapVirtualKeyW(vk_code, MAPVK_VK_TO_VSC_EX);
-    } else {
-        scan_code = MapVirtualKeyW(vk_code, MAPVK_VK_TO_VSC);
-    }
-    
-    // Construct detailed lParam for key down
-    LPARAM lParam_down = 1                // Repeat count (bits 0-15)
-                    | (scan_code << 16)   // Scan code (bits 16-23)
-                    | (0 << 24)           // Extended key flag
-                    | (0 << 25)           // Don't care (bit 25)
-                    | (0 << 26)           // Alt state (bit 26)
-                    | (0 << 27)           // Don't care (bit 27)
-                    | (0 << 28)           // Previous state (bit 28)
-                    | (0 << 29)           // Transition state (bit 29)
-                    | (0 << 30)           // Don't care (bit 30)
-                    | (0 << 31);          // Don't care (bit 31)
-
-    // Construct lParam for key up (set transition and previous state flags)
-    LPARAM lParam_up = lParam_down | (1 << 30) | (1 << 29);
-
-    std::cout << "Posting key 0x" << std::hex << vk_code 
-              << " with scan code 0x" << scan_code 
-              << " down_lParam: 0x" << lParam_down
-              << " up_lParam: 0x" << lParam_up << std::dec << std::endl;
-
-    SendMessage(target_hwnd, WM_KEYDOWN, vk_code, lParam_down);
-    Sleep(50);  // Small delay between down and up
-    SendMessage(target_hwnd, WM_KEYUP, vk_code, lParam_up);
-}
-
-void input_sender_context::simulate_key_combination(const std::vector<WORD>& vk_codes) {
-    std::cout << "Simulating key combination of " << vk_codes.size() << " keys" << std::endl;
-    
-    // First, prepare all lParams
-    std::vector<std::pair<LPARAM, LPARAM>> key_params;
     for (WORD vk_code : vk_codes) {
-        UINT scan_code;
-        if ((vk_code >= 'A' && vk_code <= 'Z') || (vk_code >= '0' && vk_code <= '9')) {
-            scan_code = MapVirtualKeyW(vk_code, MAPVK_VK_TO_VSC_EX);
-        } else {
-            scan_code = MapVirtualKeyW(vk_code, MAPVK_VK_TO_VSC);
+        queue_key_down(vk_code, vk_to_scan_code(vk_code), vk_is_extended(vk_code));
+    }
+    flush_burst();
+
+    // Same deadline for all, timers due together fire in the order scheduled
+    uint64_t release_ns = now_ns() + hold_ns;
+    for (size_t i = vk_codes.size(); i > 0; i--) {
+        schedule_release(vk_codes[i-1], release_ns);
+    }
+}
+
+void input_sender_context::queue_key_down(uint16_t vk_code, uint16_t scan_code, bool extended) {
+    held_key& key = held_keys[vk_code & 0xFF];
+    if (key.down) {
+        queue_key_up(vk_code);  // Pressed again before its key-up was due
+    }
+    burst.push_back(key_transition{vk_code, scan_code, extended, true});
+    key.down = true;
+    key.scan_code = scan_code;
+    key.extended = extended;
+    key.generation++;
+}
+
+void input_sender_context::queue_key_up(uint16_t vk_code) {
+    held_key& key = held_keys[vk_code & 0xFF];
+    if (!key.down) {
+        return;
+    }
+    burst.push_back(key_transition{vk_code, key.scan_code, key.extended, false});
+    key.down = false;
+}
+
+size_t input_sender_context::flush_burst() {
+    if (burst.empty()) {
+        return 0;
+    }
+    // An unhealthy window gets nothing, held keys are released on recovery
+    bool attempted = breaker.closed();
+    size_t injected = attempted ? injector->inject(target_hwnd, burst.data(), burst.size()) : 0;
+    bool timed_out = attempted && injected < burst.size() && injector->last_error() == inject_error::timeout;
+    if (injected == burst.size()) {
+        breaker.record_success();
+    } else if (attempted) {
+        if (timed_out) {
+            injection_timeouts++;
         }
+        LOG_WARN("{}: {} injector delivered {} of {} key transitions{}",
+                 context_name, injector->name(), injected, burst.size(), timed_out ? " (timed out)" : "");
+        if (breaker.record_failure(now_ns())) {
+            LOG_WARN("{}: window 0x{} is not responding, {} its input until it recovers",
+                     context_name, target_hwnd,
+                     breaker.config().policy == open_policy::park ? "parking" : "dropping");
+        }
+    }
+    // Undo the key state of everything that was not delivered. A timed-out
+    // key down stays queued in the window and may land later, so it counts
+    // as held and is released with the rest on recovery.
+    for (size_t i = burst.size(); i > injected; --i) {
+        const key_transition& lost = burst[i - 1];
+        if (timed_out && i - 1 == injected && lost.down) {
+            continue;
+        }
+        held_keys[lost.vk_code & 0xFF].down = !lost.down;
+    }
+    burst.clear();
+    return injected;
+}
 
-        LPARAM lParam_down = 1 | (scan_code << 16);
-        LPARAM lParam_up = lParam_down | (1 << 30) | (1 << 29);
-        key_params.push_back({lParam_down, lParam_up});
+void input_sender_context::discard_burst(uint16_t sync_token) {
+    for (size_t i = burst.size(); i > 0; --i) {
+        const key_transition& lost = burst[i - 1];
+        held_keys[lost.vk_code & 0xFF].down = !lost.down;
     }
+    burst.clear();
+    burst_messages.clear();
+    if (sync_token != 0) {
+        barrier.skip(sync_token);  // The other windows must not wait for this one
+    }
+}
+
+bool input_sender_context::parked() const {
+    return !breaker.closed() && breaker.config().policy == open_policy::park;
+}
+
+void input_sender_context::stash_parked(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (parked_backlog.size() == inbound_channel->capacity()) {
+            parked_backlog.pop_front();
+            messages_dropped++;
+        }
+        parked_backlog.push_back(batch[i]);
+    }
+}
 
-    // Send all key down messages
-    for (size_t i = 0; i < vk_codes.size(); i++) {
-        PostMessage(target_hwnd, WM_KEYDOWN, vk_codes[i], key_params[i].first);
-        Sleep(50);
+bool input_sender_context::take_backlog() {
+    if (parked_backlog.empty()) {
+        return false;
     }
+    batch.clear();
+    size_t count = std::min(parked_backlog.size(), MAX_BURST);
+    batch.assign(parked_backlog.begin(), parked_backlog.begin() + count);
+    parked_backlog.erase(parked_backlog.begin(), parked_backlog.begin() + count);
+    return true;
+}
 
-    Sleep(100);  // Hold the combination
+void input_sender_context::retarget(HWND window) {
+    next_hwnd.store(window, std::memory_order_release);
+    if (worker_strand) {
+        worker_strand->wake();
+    }
+}
 
-    // Send all key up messages in reverse order
-    for (size_t i = vk_codes.size(); i > 0; i--) {
-        PostMessage(target_hwnd, WM_KEYUP, vk_codes[i-1], key_params[i-1].second);
-        Sleep(50);
-    }
-}
-
-WORD input_sender_context::get_virtual_key_code(const std::string& key_name) {
-    // Handle special keys
-    static const std::unordered_map<std::string, WORD> special_keys = {
-        {"Enter", VK_RETURN},
-        {"Space", VK_SPACE},
-        {"Backspace", VK_BACK},
-        {"Tab", VK_TAB},
-        {"Shift", VK_SHIFT},
-        {"Ctrl", VK_CONTROL},
-        {"Alt", VK_MENU},
-        {"Esc", VK_ESCAPE},
-        {"Left", VK_LEFT},
-        {"Up", VK_UP},
-        {"Right", VK_RIGHT},
-        {"Down", VK_DOWN}
-    };
-
-    std::cout << "Converting key name: " << key_name << std::endl;
-
-    // Check special keys first
-    auto it = special_keys.find(key_name);
-    if (it != special_keys.end()) {
-        std::cout << "Found special key, VK: 0x" << std::hex << it->second << std::dec << std::endl;
-        return it->second;
-    }
-
-    // For single characters (letters or numbers)
-    if (key_name.length() == 1) {
-        char c = key_name[0];
-        if (isalpha(c)) {
-            // Handle letters (A-Z)
-            WORD vk = static_cast<WORD>(toupper(c));
-            std::cout << "Converted letter to VK: 0x" << std::hex << vk << std::dec << std::endl;
-            return vk;
+void input_sender_context::adopt_window() {
+    HWND window = next_hwnd.exchange(nullptr, std::memory_order_acquire);
+    if (!window || window == target_hwnd) {
+        return;
+    }
+    LOG_INFO("{}: switching from window 0x{} to 0x{}", context_name, target_hwnd, window);
+    // Keys held in the old window went with it, pending key-ups must not
+    // reach the new one
+    for (auto& key : held_keys) {
+        if (key.down) {
+            key.down = false;
+            key.generation++;
         }
-        else if (isdigit(c)) {
-            // Handle numbers (0-9)
-            WORD vk = static_cast<WORD>(c);
-            std::cout << "Converted number to VK: 0x" << std::hex << vk << std::dec << std::endl;
-            return vk;
+    }
+    target_hwnd = window;
+    retargets++;
+    if (!breaker.closed()) {
+        breaker.record_success();  // Its failures were the old window's
+    }
+}
+
+void input_sender_context::probe_if_due() {
+    if (!breaker.probe_due(now_ns())) {
+        return;
+    }
+    breaker.begin_probe();
+    if (injector->probe(target_hwnd)) {
+        breaker.record_success();
+        LOG_INFO("{}: window 0x{} responds again, resuming input", context_name, target_hwnd);
+        // Keys that went down before the hang may never have been released
+        release_all_keys();
+    } else {
+        breaker.record_failure(now_ns());
+        LOG_DEBUG("{}: window 0x{} still not responding", context_name, target_hwnd);
+    }
+}
+
+void input_sender_context::schedule_release(uint16_t vk_code, uint64_t release_ns) {
+    key_releases.schedule(release_ns, pending_release{vk_code, held_keys[vk_code & 0xFF].generation});
+}
+
+void input_sender_context::release_due_keys(bool spin) {
+    uint64_t due_ns = key_releases.next_deadline();
+    if (due_ns == NO_DEADLINE) {
+        return;
+    }
+    if (spin && timing.coarse_deadline(due_ns) <= now_ns()) {
+        timing.spin_until(due_ns);
+    }
+    key_releases.advance(now_ns(), [this](const pending_release& release, uint64_t) {
+        // A re-press since scheduling owns the key now
+        if (held_keys[release.vk_code & 0xFF].generation == release.generation) {
+            queue_key_up(release.vk_code);
         }
+    });
+    flush_burst();
+}
+
+void input_sender_context::release_all_keys() {
+    // Never leave a key stuck down in the target window
+    for (int vk = 0; vk < 256; ++vk) {
+        queue_key_up(static_cast<uint16_t>(vk));
     }
+    flush_burst();
+}
 
-    std::cout << "No conversion found for key: " << key_name << std::endl;
-    return 0;  // Unknown key
+breaker_config input_sender_context::load_breaker_config(const std::string& process_id) {
+    const ProcessConfig* config = SettingsManager::getInstance().findProcessConfig(process_id);
+    return config ? config->breaker : breaker_config{};
+}
+
+std::unique_ptr<i_input_injector> input_sender_context::create_injector(const std::string& process_id) {
+    const ProcessConfig* config = SettingsManager::getInstance().findProcessConfig(process_id);
+    injector_type type = config ? config->injector : injector_type::send_message;
+    switch (type) {
+        case injector_type::post_message:
+            return std::make_unique<post_message_injector>();
+        case injector_type::send_input:
+            return std::make_unique<send_input_injector>();
+        case injector_type::recording:
+            return std::make_unique<recording_injector>();
+        case injector_type::send_message:
+        default:
+            return std::make_unique<send_message_injector>();
+    }
 }
 
 void input_sender_context::start() {
-    worker_thread = std::thread(&input_sender_context::operator(), this);
+    if (!worker_pool) {
+        worker_thread = std::thread(&input_sender_context::operator(), this);
+        return;
+    }
+    worker_strand = worker_pool->add_strand([this]() { return run_once(); });
+    inbound_channel->set_wakeup_listener(worker_strand);
+    worker_strand->wake();  // Picks up anything queued before start
+    LOG_INFO("{} running as a strand", context_name);
 }
 
 void input_sender_context::stop() {
     if (worker_thread.joinable()) {
         worker_thread.join();
     }
+    if (worker_strand) {
+        inbound_channel->set_wakeup_listener(nullptr);
+        worker_pool->retire(worker_strand);
+        worker_strand = nullptr;
+        release_all_keys();
+    }
 }
 
 void input_sender_context::print_metrics() const {
@@ -218,9 +416,39 @@ void input_sender_context::print_metrics() const {
               << " Messages Processed: " << messages_processed
               << " Messages Sent: " << messages_sent
               << " Inputs Sent: " << inputs_sent
-              << " Inbound Queue: " << inbound_channel->messages.size()
-              << " Outbound Queue: " << outbound_channel->messages.size()
+              << " Dropped: " << messages_dropped
+              << " Inbound Queue: " << inbound_channel->size()
+              << " Outbound Queue: " << outbound_channel->size()
+              << std::endl;
+
+    std::cout << "  Health: " << breaker_state_name(breaker.current())
+              << " Trips: " << breaker.trips()
+              << " Probes: " << breaker.probes()
+              << " Recoveries: " << breaker.recoveries()
+              << " Timeouts: " << injection_timeouts
+              << " Retargets: " << retargets
+              << std::endl;
+
+    overflow_stats overflow = inbound_channel->get_overflow_stats();
+    std::cout << "  Inbound overflow:"
+              << " Dropped: " << overflow.dropped
+              << " Evicted: " << overflow.evicted
+              << " Coalesced: " << overflow.coalesced
+              << " Blocked: " << overflow.blocked
+              << " High Water: " << overflow.high_water << "/" << inbound_channel->capacity()
+              << std::endl;
+
+    wait_stats waits = inbound_channel->get_wait_stats();
+    std::cout << "  Inbound " << inbound_channel->type_name() << " channel waits:"
+              << " Spin: " << waits.spin_wakeups
+              << " Yield: " << waits.yield_wakeups
+              << " Park: " << waits.parks
               << std::endl;
+    latency.detect_to_enqueue.print(std::cout, "detect->enqueue");
+    latency.enqueue_to_dequeue.print(std::cout, "enqueue->dequeue");
+    latency.dequeue_to_inject.print(std::cout, "dequeue->inject");
+    latency.injection.print(std::cout, injector->name());
+    latency.end_to_end.print(std::cout, "detect->injected");
 }
 
 void input_sender_context::set_name(const std::string& name) {
@@ -0,0 +1,23 @@
+#include "i_input_source.h"
+
+bool parse_input_source_type(const std::string& name, input_source_type& type) {
+    if (name == "hook") {
+        type = input_source_type::hook;
+    } else if (name == "poll") {
+        type = input_source_type::poll;
+    } else if (name == "replay") {
+        type = input_source_type::replay;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* input_source_type_name(input_source_type type) {
+    switch (type) {
+        case input_source_type::poll: return "poll";
+        case input_source_type::replay: return "replay";
+        case input_source_type::hook:
+        default: return "hook";
+    }
+}
@@ -0,0 +1,293 @@
+#include "key_dispatcher.h"
+#include "logger.h"
+#include "key_codes.h"
+#include <algorithm>
+#include <iostream>
+
+void key_dispatcher::on_key_down(uint16_t vk_code, uint64_t detected_ns) {
+    const dispatch_plan* plan = vk_code < dispatch_table.size() ? dispatch_table[vk_code] : nullptr;
+    if (!plan) {
+        return;
+    }
+
+    if (!plan->moments.empty()) {
+        start(scheduled_step{plan, nullptr, 0, detected_ns}, plan->moments[0].offset_ns);
+        return;
+    }
+
+    // Every sequence starts right away, delays only hold back their own sequence
+    for (const auto& group : plan->groups) {
+        if (group.steps.empty()) {
+            continue;
+        }
+        start(scheduled_step{plan, &group, 0, detected_ns}, group.steps[0].offset_ns);
+    }
+}
+
+void key_dispatcher::start(const scheduled_step& pending, uint64_t first_offset_ns) {
+    // A sequence that opens with a delay waits it out like any later step
+    if (first_offset_ns > 0) {
+        action_timers.schedule(pending.detected_ns + first_offset_ns, pending);
+    } else if (pending.group) {
+        run_steps(pending);
+    } else {
+        run_moment(pending);
+    }
+}
+
+void key_dispatcher::run_due(uint64_t now_ns) {
+    action_timers.advance(now_ns, [this](const scheduled_step& pending, uint64_t) {
+        if (pending.group) {
+            run_steps(pending);
+        } else {
+            run_moment(pending);
+        }
+    });
+}
+
+void key_dispatcher::run_steps(const scheduled_step& pending) {
+    const fan_out_group& group = *pending.group;
+    uint64_t offset_ns = group.steps[pending.next_step].offset_ns;
+    for (size_t i = pending.next_step; i < group.steps.size(); ++i) {
+        const dispatch_step& step = group.steps[i];
+        if (step.offset_ns != offset_ns) {
+            // Due times come from the trigger, so late steps never push back later ones
+            scheduled_step next = pending;
+            next.next_step = static_cast<uint32_t>(i);
+            action_timers.schedule(pending.detected_ns + step.offset_ns, next);
+            return;
+        }
+        dispatch_step_message(pending, group, step, 0);
+    }
+}
+
+void key_dispatcher::run_moment(const scheduled_step& pending) {
+    const sync_moment& moment = pending.plan->moments[pending.next_step];
+    if (pending.next_step + 1 < pending.plan->moments.size()) {
+        scheduled_step next = pending;
+        next.next_step++;
+        action_timers.schedule(pending.detected_ns + pending.plan->moments[next.next_step].offset_ns, next);
+    }
+
+    // Without a free barrier the keys still go out, just unsynchronized
+    uint16_t token = 0;
+    uint64_t timeout_ns = static_cast<uint64_t>(std::max(pending.plan->binding->sync_timeout_ms, 0)) * 1'000'000;
+    bool synchronized = barrier.open(moment.windows, now_ns() + timeout_ns, token);
+    if (!synchronized) {
+        LOG_WARN("No free barrier for synchronous binding {}, sending unsynchronized",
+                 pending.plan->binding->trigger_key);
+    }
+
+    uint64_t reached = 0;
+    for (const auto& entry : moment.entries) {
+        const dispatch_step& step = entry.group->steps[entry.step];
+        reached |= dispatch_step_message(pending, *entry.group, step, synchronized ? token : 0);
+    }
+    if (synchronized) {
+        // Windows that were not reached must not hold up the others
+        barrier.withdraw(token, moment.windows - static_cast<uint32_t>(bit_count(reached)));
+    }
+}
+
+uint64_t key_dispatcher::dispatch_step_message(const scheduled_step& pending, const fan_out_group& group,
+                                               const dispatch_step& step, uint16_t sync_token) {
+    uint64_t due_ns = pending.detected_ns + step.offset_ns;
+    message key_msg = step.msg;
+    key_msg.m_msg_id = next_msg_id++;
+    key_msg.timestamp_ns = pending.detected_ns;
+    if (sync_token != 0) {
+        key_msg.m_flags |= KEY_FLAG_SYNC;
+        key_msg.sync_token = sync_token;
+    }
+    uint64_t reached = send_action(group, key_msg);
+    if (!reached) {
+        return 0;
+    }
+    int64_t jitter_ns = static_cast<int64_t>(key_msg.enqueue_ns - due_ns);
+    if (step.offset_ns > 0) {
+        timeline_jitter.record(jitter_ns > 0 ? static_cast<uint64_t>(jitter_ns) : 0);
+    }
+    LOG_DEBUG("Key sequence action: trigger {} key {} -> {} windows (Message ID: {}, +{}us, jitter {}us)",
+              pending.plan->binding->trigger_key, vk_to_key_name(key_msg.vk_code), bit_count(reached),
+              key_msg.m_msg_id, step.offset_ns / 1000, jitter_ns / 1000);
+    return reached;
+}
+
+void key_dispatcher::compile(const std::vector<KeyBinding>& key_bindings,
+                             const std::vector<std::string>& process_ids, size_t pool_workers) {
+    process_names = process_ids;
+    dispatch_plans.clear();
+    dispatch_plans.reserve(key_bindings.size());
+    for (const auto& binding : key_bindings) {
+        if (binding.trigger_vk == 0 || binding.trigger_vk >= dispatch_table.size()) {
+            continue;
+        }
+        dispatch_plan plan;
+        plan.binding = &binding;
+        plan.groups = build_fan_out_groups(binding);
+        dispatch_plans.push_back(std::move(plan));
+        if (binding.synchronous) {
+            dispatch_plan& added = dispatch_plans.back();
+            added.moments = build_sync_moments(added.groups);
+            warn_if_pool_too_small(added, pool_workers);
+        }
+    }
+
+    // The first binding for a key wins. Generic modifiers also claim their
+    // left and right codes, which is what the input sources report.
+    dispatch_table.fill(nullptr);
+    auto claim = [this](uint16_t vk, const dispatch_plan& plan) {
+        if (!dispatch_table[vk]) {
+            dispatch_table[vk] = &plan;
+        }
+    };
+    for (const auto& plan : dispatch_plans) {
+        uint16_t vk = plan.binding->trigger_vk;
+        claim(vk, plan);
+        uint16_t left, right;
+        if (modifier_sides(vk, left, right)) {
+            claim(left, plan);
+            claim(right, plan);
+        }
+    }
+    LOG_INFO("Compiled {} key bindings into the dispatch table", dispatch_plans.size());
+}
+
+std::vector<fan_out_group> key_dispatcher::build_fan_out_groups(const KeyBinding& binding) const {
+    auto same_actions = [](const KeySequence& a, const KeySequence& b) {
+        if (a.actions.size() != b.actions.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.actions.size(); ++i) {
+            if (a.actions[i].vk_code != b.actions[i].vk_code ||
+                a.actions[i].delay != b.actions[i].delay ||
+                a.actions[i].hold != b.actions[i].hold) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<fan_out_group> groups;
+    for (const auto& sequence : binding.sequences) {
+        uint64_t targets = router.resolve(sequence.targets);
+        if (!targets) {
+            continue;
+        }
+
+        auto merged = std::find_if(groups.begin(), groups.end(), [&](const fan_out_group& group) {
+            return same_actions(*group.sequence, sequence);
+        });
+        if (merged != groups.end()) {
+            merged->targets |= targets;
+            continue;
+        }
+
+        fan_out_group group;
+        group.sequence = &sequence;
+        group.targets = targets;
+        groups.push_back(group);
+    }
+
+    // A single window keeps its ids in the messages, groups are routed by
+    // mask only and their receivers accept any process id
+    for (auto& group : groups) {
+        if (bit_count(group.targets) == 1) {
+            const target_selector& target = router.target(lowest_bit(group.targets));
+            group.target_process = static_cast<int16_t>(target.process_index);
+            group.target_instance = static_cast<int16_t>(target.instance);
+        }
+    }
+
+    // Compile each sequence into a timeline of offsets from the trigger.
+    // Pure delays only move the offset of the keys after them.
+    for (auto& group : groups) {
+        uint64_t offset_ns = 0;
+        for (const auto& action : group.sequence->actions) {
+            if (action.vk_code != 0) {
+                dispatch_step step;
+                step.msg = message(message_command::key_press, 0, action.vk_code, action.scan_code,
+                                   group.target_process, group.target_instance);
+                step.msg.hold_us = static_cast<uint32_t>(std::max(action.hold, 0)) * 1000;
+                step.msg.m_flags = action.extended ? KEY_FLAG_EXTENDED : KEY_FLAG_NONE;
+                step.offset_ns = offset_ns;
+                group.steps.push_back(step);
+            }
+            offset_ns += static_cast<uint64_t>(std::max(action.delay, 0)) * 1'000'000;
+        }
+    }
+    return groups;
+}
+
+std::vector<sync_moment> key_dispatcher::build_sync_moments(const std::vector<fan_out_group>& groups) {
+    // Merge the timelines of all groups, keys at the same offset form a moment
+    std::vector<sync_moment> moments;
+    for (const auto& group : groups) {
+        for (uint32_t i = 0; i < group.steps.size(); ++i) {
+            uint64_t offset_ns = group.steps[i].offset_ns;
+            auto moment = std::find_if(moments.begin(), moments.end(), [offset_ns](const sync_moment& m) {
+                return m.offset_ns == offset_ns;
+            });
+            if (moment == moments.end()) {
+                moments.push_back(sync_moment{});
+                moment = moments.end() - 1;
+                moment->offset_ns = offset_ns;
+            }
+            moment->entries.push_back(sync_moment::entry{&group, i});
+        }
+    }
+    std::stable_sort(moments.begin(), moments.end(), [](const sync_moment& a, const sync_moment& b) {
+        return a.offset_ns < b.offset_ns;
+    });
+
+    for (auto& moment : moments) {
+        uint64_t targets = 0;
+        for (const auto& entry : moment.entries) {
+            targets |= entry.group->targets;
+        }
+        moment.windows = static_cast<uint32_t>(bit_count(targets));
+    }
+    return moments;
+}
+
+void key_dispatcher::warn_if_pool_too_small(const dispatch_plan& plan, size_t pool_workers) const {
+    // Strands spinning at a barrier hold their worker, so every window of a
+    // moment needs a worker of its own or the barrier runs into its timeout
+    if (pool_workers == 0) {
+        return;
+    }
+    for (const auto& moment : plan.moments) {
+        if (moment.windows > pool_workers) {
+            LOG_WARN("Synchronous binding {} reaches {} windows at once but the pool has {} workers",
+                     plan.binding->trigger_key, moment.windows, pool_workers);
+            return;
+        }
+    }
+}
+
+uint64_t key_dispatcher::send_action(const fan_out_group& group, message& key_msg) {
+    key_msg.enqueue_ns = now_ns();
+    uint64_t reached = router.fan_out(key_msg, group.targets);
+    if (reached) {
+        sent_count++;
+        keys_count++;
+        detect_to_enqueue.record(key_msg.enqueue_ns - key_msg.timestamp_ns);
+    }
+    uint64_t missed_targets = group.targets & router.active_targets() & ~reached;
+    for (uint64_t missed = missed_targets; missed != 0; missed &= missed - 1) {
+        // Usually a sender stuck on a hung window, its breaker drains the queue
+        const target_selector& target = router.target(lowest_bit(missed));
+        dropped_count++;
+        LOG_WARN("Channel for {}:{} is full, dropped key {}",
+                 static_cast<size_t>(target.process_index) < process_names.size()
+                     ? process_names[target.process_index] : std::string("?"),
+                 target.instance, vk_to_key_name(key_msg.vk_code));
+    }
+    return reached;
+}
+
+void key_dispatcher::print_metrics() const {
+    detect_to_enqueue.print(std::cout, "detect->enqueue");
+    timeline_jitter.print(std::cout, "timeline jitter");
+    barrier.print_metrics();
+}
@@ -1,8 +1,12 @@
 #include "key_monitor_context.h"
 #include "settings_manager.h"
 #include "thread_manager.h"
+#include "timing.h"
+#include "logger.h"
+#include "hook_input_source.h"
+#include "poll_input_source.h"
+#include "replay_input_source.h"
 #include <iostream>
-#include <sstream>
 
 key_monitor_context::key_monitor_context(std::shared_ptr<message_channel> outbound_channel,
                                        std::shared_ptr<message_channel> inbound_channel,
@@ -11,84 +15,85 @@ key_monitor_context::key_monitor_context(std::shared_ptr<message_channel> outbou
     , inbound_channel(inbound_channel)
     , running(running)
     , msg_sender(outbound_channel, running)
-    , msg_receiver(inbound_channel, running) {
-    std::cout << "Key monitor context created" << std::endl;
+    , msg_receiver(inbound_channel, running)
+    , input(create_input_source(SettingsManager::getInstance().getInputConfig()))
+    , dispatcher(thread_manager::get_router()) {
+    LOG_INFO("Key monitor context created");
 }
 
 void key_monitor_context::operator()() {
-    std::cout << "Key monitor thread started - Monitoring for key presses..." << std::endl;
-    uint32_t msg_id = 0;
+    LOG_INFO("Key monitor thread started - Waiting for key events from {} source", input->name());
 
-    const auto& key_bindings = SettingsManager::getInstance().getKeyBindings();
-    bool previous_state[256] = {false};
+    // Channels exist once the input senders are added, resolve targets up front
+    compile_dispatch_table();
 
+    bool key_down[256] = {false};
+    input_event event;
     while (running) {
-        for (int vk = 0; vk < 256; vk++) {
-            bool current_state = (GetAsyncKeyState(vk) & 0x8000) != 0;
-            
-            if (current_state && !previous_state[vk]) {
-                std::string key_name = get_key_name(vk);
-                if (!key_name.empty()) {
-                    for (const auto& binding : key_bindings) {
-                        if (binding.trigger_key == key_name) {
-                            // Process all sequences for this trigger key
-                            for (const auto& sequence : binding.sequences) {
-                                // Get correct channel for target process
-                                std::ostringstream oss;
-                                oss << sequence.target_process << ":" << sequence.instance;
-                                std::string target_id = oss.str();
-                                
-                                auto channel = thread_manager::get_input_channel(target_id);
-                                if (channel) {
-                                    // Send each action in the sequence
-                                    for (const auto& action : sequence.actions) {
-                                        message key_msg(2, msg_id++, "Key pressed: " + action.key,
-                                                     sequence.target_process,
-                                                     sequence.instance);
-                                        
-                                        sender target_sender(channel, running);
-                                        if (target_sender.send_message(key_msg)) {
-                                            messages_sent++;
-                                            keys_processed++;
-                                            std::cout << "Key sequence action:\n"
-                                                      << "  Trigger: " << key_name << "\n"
-                                                      << "  Action Key: " << action.key << "\n"
-                                                      << "  Process: " << sequence.target_process << "\n"
-                                                      << "  Instance: " << sequence.instance << "\n"
-                                                      << "  Message ID: " << msg_id - 1;
-                                            
-                                            if (action.delay > 0) {
-                                                std::cout << "\n  Delay: " << action.delay << "ms";
-                                                Sleep(action.delay);
-                                            }
-                                            std::cout << std::endl;
-                                        }
-                                    }
-                                }
-                            }
-                            break;  // Found the trigger key binding, no need to check others
-                        }
-                    }
+        // Delayed actions run on this thread too, so the wait for input ends
+        // shortly before the next due action and the channels keep a single
+        // producer. The rest of the way is spun for sub-millisecond accuracy.
+        uint64_t wait_until = timing.coarse_deadline(dispatcher.next_deadline());
+        bool timed_wait = wait_until != NO_DEADLINE && wait_until > now_ns();
+        if (input->next_event(event, wait_until)) {
+            if (event.vk_code < 256) {
+                bool was_down = key_down[event.vk_code];
+                key_down[event.vk_code] = event.key_down;
+                // Releases and auto-repeat do not trigger bindings
+                if (event.key_down && !was_down) {
+                    dispatcher.on_key_down(event.vk_code, event.timestamp_ns);
                 }
             }
-            previous_state[vk] = current_state;
+        } else if (timed_wait) {
+            timing.record_wakeup(wait_until, now_ns());
         }
-        Sleep(1);
+
+        uint64_t due_ns = dispatcher.next_deadline();
+        if (due_ns != NO_DEADLINE && timing.coarse_deadline(due_ns) <= now_ns()) {
+            timing.spin_until(due_ns);
+        }
+        dispatcher.run_due(now_ns());
     }
 }
 
+void key_monitor_context::compile_dispatch_table() {
+    const SettingsManager& settings = SettingsManager::getInstance();
+    std::vector<std::string> process_ids;
+    for (const auto& config : settings.getProcessConfigs()) {
+        process_ids.push_back(config.id);
+    }
+    const ExecutionConfig& execution = settings.getExecutionConfig();
+    size_t pool_workers = 0;
+    if (execution.mode == execution_mode::pool) {
+        pool_workers = execution.workers ? execution.workers : std::thread::hardware_concurrency();
+    }
+    dispatcher.compile(settings.getKeyBindings(), process_ids, pool_workers);
+}
+
 void key_monitor_context::process_message(const message& msg) {
-    std::cout << context_name << " received message - Command: " << msg.m_command 
-              << " ID: " << msg.m_msg_id 
-              << " Content: " << msg.m_msg << std::endl;
+    LOG_DEBUG("{} received message - Command: {} ID: {}", context_name, msg.m_command, msg.m_msg_id);
     messages_processed++;
 }
 
 void key_monitor_context::start() {
+    if (!input->start()) {
+        // Polling sees keys injected with SendInput as typed, see loadSettings()
+        for (const auto& config : SettingsManager::getInstance().getProcessConfigs()) {
+            if (config.injector == injector_type::send_input) {
+                LOG_ERROR("{} input source failed to start and {} injects with send_input, key monitor not running",
+                          input->name(), config.id);
+                return;
+            }
+        }
+        LOG_WARN("{} input source failed to start, falling back to polling", input->name());
+        input = std::make_unique<poll_input_source>();
+        input->start();
+    }
     worker_thread = std::thread(&key_monitor_context::operator(), this);
 }
 
 void key_monitor_context::stop() {
+    input->stop();
     if (worker_thread.joinable()) {
         worker_thread.join();
     }
@@ -96,39 +101,28 @@ void key_monitor_context::stop() {
 
 void key_monitor_context::print_metrics() const {
     std::cout << context_name << " Metrics:"
-              << " Keys Processed: " << keys_processed
+              << " Keys Processed: " << dispatcher.keys_processed()
               << " Messages Processed: " << messages_processed
-              << " Messages Sent: " << messages_sent
-              << " Inbound Queue: " << inbound_channel->messages.size()
-              << " Outbound Queue: " << outbound_channel->messages.size()
+              << " Messages Sent: " << dispatcher.messages_sent()
+              << " Dropped: " << dispatcher.messages_dropped()
+              << " Inbound Queue: " << inbound_channel->size()
+              << " Outbound Queue: " << outbound_channel->size()
               << std::endl;
+    dispatcher.print_metrics();
+}
+
+std::unique_ptr<i_input_source> key_monitor_context::create_input_source(const InputConfig& config) {
+    switch (config.source) {
+        case input_source_type::poll:
+            return std::make_unique<poll_input_source>();
+        case input_source_type::replay:
+            return std::make_unique<replay_input_source>(config.replay_file, config.paced);
+        case input_source_type::hook:
+        default:
+            return std::make_unique<hook_input_source>();
+    }
 }
 
 void key_monitor_context::set_name(const std::string& name) {
     context_name = name;
 }
-
-std::string key_monitor_context::get_key_name(DWORD vk_code) {
-    // Handle special keys
-    switch (vk_code) {
-        case VK_RETURN: return "Enter";
-        case VK_SPACE: return "Space";
-        case VK_BACK: return "Backspace";
-        case VK_TAB: return "Tab";
-        case VK_SHIFT: return "Shift";
-        case VK_CONTROL: return "Ctrl";
-        case VK_MENU: return "Alt";
-        case VK_ESCAPE: return "Esc";
-        case VK_LEFT: return "Left";
-        case VK_UP: return "Up";
-        case VK_RIGHT: return "Right";
-        case VK_DOWN: return "Down";
-        default:
-            // For standard keys
-            if ((vk_code >= '0' && vk_code <= '9') || 
-                (vk_code >= 'A' && vk_code <= 'Z')) {
-                return std::string(1, (char)vk_code);
-            }
-            return "";
-    }
-}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "latency_histogram.h"
+#include "platform_hints.h"
+#include <algorithm>
+#include <iomanip>
+
+latency_histogram::latency_histogram() {
+    reset();
+}
+
+int latency_histogram::bucket_index(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<int>(value);
+    }
+    int shift = highest_bit(value) - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + static_cast<int>(value >> shift) - SUB_BUCKETS;
+}
+
+uint64_t latency_histogram::bucket_upper_bound(int index) {
+    int magnitude = index / SUB_BUCKETS;
+    uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS);
+    if (magnitude == 0) {
+        return sub;
+    }
+    int shift = magnitude - 1;
+    uint64_t lower = (SUB_BUCKETS + sub) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void latency_histogram::record(uint64_t value_ns) {
+    buckets[bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+    total_count.fetch_add(1, std::memory_order_relaxed);
+    total_sum.fetch_add(value_ns, std::memory_order_relaxed);
+    uint64_t current = max_value.load(std::memory_order_relaxed);
+    while (value_ns > current &&
+           !max_value.compare_exchange_weak(current, value_ns, std::memory_order_relaxed)) {
+    }
+}
+
+void latency_histogram::reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total_count.store(0, std::memory_order_relaxed);
+    total_sum.store(0, std::memory_order_relaxed);
+    max_value.store(0, std::memory_order_relaxed);
+}
+
+double latency_histogram::mean() const {
+    uint64_t n = count();
+    return n ? static_cast<double>(total_sum.load(std::memory_order_relaxed)) / static_cast<double>(n) : 0.0;
+}
+
+uint64_t latency_histogram::percentile(double p) const {
+    uint64_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(n - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucket_upper_bound(i), max());
+        }
+    }
+    return max();
+}
+
+void latency_histogram::print(std::ostream& out, const char* label) const {
+    auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+    std::ios::fmtflags flags = out.flags();
+    out << "  " << std::left << std::setw(20) << label << std::right
+        << " count " << count()
+        << std::fixed << std::setprecision(1)
+        << "  p50 " << us(percentile(0.50)) << "us"
+        << "  p99 " << us(percentile(0.99)) << "us"
+        << "  p99.9 " << us(percentile(0.999)) << "us"
+        << "  max " << us(max()) << "us"
+        << "\n";
+    out.flags(flags);
+}
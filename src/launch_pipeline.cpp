@@ -0,0 +1,400 @@
+#include "launch_pipeline.h"
+#include "logger.h"
+#include "timing.h"
+#include <algorithm>
+
+namespace {
+constexpr uint16_t VK_ENTER = 0x0D;
+constexpr uint32_t ENTER_DELAY_MS = 500;  // Lets a fresh window start handling input
+constexpr uint32_t ENTER_HOLD_MS = 100;
+}
+
+std::vector<launch_result> launch_pipeline::run(const std::vector<launch_spec>& specs) {
+    tasks.clear();
+    task_by_pid.clear();
+    unrelated_pids.clear();
+    registry.refresh();
+    std::vector<window_handle> handles = windows.list_handles();
+    existing_windows = std::unordered_set<window_handle>(handles.begin(), handles.end());
+    timers = timer_wheel<timer>(TIMER_TICK_NS);
+    pending = 0;
+
+    tasks.resize(specs.size());
+    uint64_t now = now_ns();
+    for (size_t i = 0; i < specs.size(); ++i) {
+        task& t = tasks[i];
+        t.result.spec = specs[i];
+        t.started_ns = now;
+        t.steps = specs[i].steps.empty() ? default_launch_steps(specs[i].window_sequence) : specs[i].steps;
+        t.matchers.resize(t.steps.size());
+        bool compiled = true;
+        for (size_t step = 0; step < t.steps.size(); ++step) {
+            if (t.steps[step].type != launch_step_type::send_keys && !t.steps[step].pattern.empty()) {
+                t.matchers[step].add(t.steps[step].pattern, t.steps[step].match, 0);
+                compiled = compiled && t.matchers[step].compile();
+            }
+        }
+        if (t.steps.empty()) {
+            t.result.state = launch_state::failed;
+            t.result.error = "no launch steps";
+            LOG_ERROR("Launch of {} instance {} failed: {}", specs[i].id, specs[i].instance, t.result.error);
+            continue;
+        }
+        if (!compiled) {
+            t.result.state = launch_state::failed;
+            t.result.error = "invalid title pattern in launch steps";
+            LOG_ERROR("Launch of {} instance {} failed: {}", specs[i].id, specs[i].instance, t.result.error);
+            continue;
+        }
+        if (cancelled) {
+            t.result.state = launch_state::failed;
+            t.result.error = "cancelled";
+            continue;
+        }
+        if (!windows.launch(specs[i].path, specs[i].args, t.result.process)) {
+            t.result.state = launch_state::failed;
+            t.result.error = "failed to start " + specs[i].path;
+            LOG_ERROR("Launch of {} instance {} failed: {}", specs[i].id, specs[i].instance, t.result.error);
+            continue;
+        }
+        LOG_INFO("Launched {} instance {} (pid {})", specs[i].id, specs[i].instance, t.result.process.pid);
+        task_by_pid[t.result.process.pid] = i;
+        pending++;
+        begin_step(t, now);
+    }
+    if (pending > 0) {
+        timers.schedule(now + RESCAN_INTERVAL_NS, timer{RESCAN, 0});
+    }
+
+    while (pending > 0 && !cancelled) {
+        window_event event;
+        if (windows.next_event(event, timers.next_deadline())) {
+            on_event(event, now_ns());
+        }
+        timers.advance(now_ns(), [this](const timer& fired, uint64_t) {
+            on_timer(fired, now_ns());
+        });
+    }
+
+    if (pending > 0) {
+        for (auto& t : tasks) {
+            if (t.result.state != launch_state::ready && t.result.state != launch_state::failed) {
+                fail(t, "cancelled", now_ns());
+            }
+        }
+    }
+
+    std::vector<launch_result> results;
+    results.reserve(tasks.size());
+    for (auto& t : tasks) {
+        results.push_back(std::move(t.result));
+    }
+    return results;
+}
+
+launch_pipeline::task* launch_pipeline::task_of(uint32_t pid) {
+    auto it = task_by_pid.find(pid);
+    if (it != task_by_pid.end()) {
+        return &tasks[it->second];
+    }
+    if (pid == 0 || unrelated_pids.count(pid)) {
+        return nullptr;
+    }
+    // Launchers often start the client as a child and exit, follow the
+    // parents up to a launched process
+    std::vector<uint32_t> chain{pid};
+    for (int depth = 0; depth < MAX_ANCESTRY; ++depth) {
+        uint32_t parent = windows.parent_pid(chain.back());
+        if (parent == 0 || unrelated_pids.count(parent) ||
+            std::find(chain.begin(), chain.end(), parent) != chain.end()) {
+            break;
+        }
+        auto launched = task_by_pid.find(parent);
+        if (launched != task_by_pid.end()) {
+            task& t = tasks[launched->second];
+            for (uint32_t descendant : chain) {
+                task_by_pid[descendant] = launched->second;
+            }
+            LOG_INFO("{} instance {}: pid {} descends from launched pid {}", t.result.spec.id,
+                     t.result.spec.instance, pid, t.result.process.pid);
+            return &t;
+        }
+        chain.push_back(parent);
+    }
+    unrelated_pids.insert(chain.begin(), chain.end());
+    return nullptr;
+}
+
+launch_pipeline::task* launch_pipeline::claim_by_title(window_handle window, uint32_t pid) {
+    if (existing_windows.count(window)) {
+        return nullptr;
+    }
+    std::string title;
+    for (auto& t : tasks) {
+        bool waiting = t.result.state == launch_state::waiting_window ||
+                       t.result.state == launch_state::waiting_title;
+        if (!waiting || t.matchers[t.step].size() == 0) {
+            continue;
+        }
+        if (title.empty()) {
+            title = windows.window_title(window);
+            if (title.empty()) {
+                return nullptr;
+            }
+        }
+        if (t.matchers[t.step].match(title) >= 0) {
+            // Later windows of the process belong to the client as well
+            unrelated_pids.erase(pid);
+            task_by_pid[pid] = static_cast<size_t>(&t - tasks.data());
+            LOG_INFO("{} instance {}: claiming window of unrelated pid {} by its title: {}",
+                     t.result.spec.id, t.result.spec.instance, pid, title);
+            return &t;
+        }
+    }
+    return nullptr;
+}
+
+void launch_pipeline::on_event(const window_event& event, uint64_t now) {
+    registry_diff diff;
+    registry.apply(event, diff);
+    task* found = task_of(event.pid);
+    if (!found && event.type != window_event_type::destroyed) {
+        found = claim_by_title(event.window, event.pid);
+    }
+    if (!found) {
+        return;
+    }
+    task& t = *found;
+    switch (event.type) {
+        case window_event_type::destroyed:
+            t.alive.erase(event.window);
+            break;
+        case window_event_type::created:
+        case window_event_type::retitled:
+            t.alive.insert(event.window);
+            consider(t, event.window, now);
+            break;
+    }
+}
+
+void launch_pipeline::on_timer(const timer& fired, uint64_t now) {
+    if (fired.task == RESCAN) {
+        rescan(now);
+        if (pending > 0) {
+            timers.schedule(now + RESCAN_INTERVAL_NS, timer{RESCAN, 0});
+        }
+        return;
+    }
+    task& t = tasks[fired.task];
+    if (fired.generation != t.generation) {
+        return;
+    }
+    switch (t.result.state) {
+        case launch_state::waiting_window:
+        case launch_state::waiting_title:
+            fail(t, "timed out in " + step_name(t), now);
+            break;
+        case launch_state::sending_keys:
+            send_keys(t, now);
+            break;
+        default:
+            break;
+    }
+}
+
+void launch_pipeline::consider(task& t, window_handle window, uint64_t now) {
+    bool new_window = t.result.state == launch_state::waiting_window && !t.old_windows.count(window);
+    if (!new_window && t.result.state != launch_state::waiting_title) {
+        return;
+    }
+    std::string title = windows.window_title(window);
+    if (title.empty()) {
+        return;  // Picked up again when it gets its title
+    }
+    const title_matcher& matcher = t.matchers[t.step];
+    if (matcher.size() > 0 && matcher.match(title) < 0) {
+        return;
+    }
+    LOG_INFO("{} instance {} {}: {}", t.result.spec.id, t.result.spec.instance, step_name(t), title);
+    t.result.window = window;
+    t.result.title = title;
+    t.step++;
+    begin_step(t, now);
+}
+
+void launch_pipeline::begin_step(task& t, uint64_t now) {
+    if (t.step >= t.steps.size()) {
+        finish(t, now);
+        return;
+    }
+    const launch_step& step = t.steps[t.step];
+    uint64_t timeout_ns = now + uint64_t{step.timeout_ms} * 1'000'000;
+    switch (step.type) {
+        case launch_step_type::wait_window:
+            // Only windows that appear from here on count
+            t.old_windows = t.alive;
+            enter_state(t, launch_state::waiting_window, timeout_ns);
+            break;
+        case launch_step_type::wait_title: {
+            enter_state(t, launch_state::waiting_title, timeout_ns);
+            // The title may already be there, the current window first
+            std::vector<window_handle> candidates(t.alive.begin(), t.alive.end());
+            if (t.result.window) {
+                candidates.insert(candidates.begin(), t.result.window);
+            }
+            size_t step_index = t.step;
+            for (window_handle window : candidates) {
+                if (t.step != step_index || t.result.state != launch_state::waiting_title) {
+                    break;  // Matched, and possibly further along already
+                }
+                if (t.alive.count(window)) {
+                    consider(t, window, now);
+                }
+            }
+            break;
+        }
+        case launch_step_type::send_keys:
+            if (!t.result.window) {
+                fail(t, step_name(t) + " has no window to send to", now);
+                return;
+            }
+            t.key = 0;
+            t.key_down = false;
+            if (step.delay_ms > 0) {
+                enter_state(t, launch_state::sending_keys, now + uint64_t{step.delay_ms} * 1'000'000);
+            } else {
+                t.result.state = launch_state::sending_keys;
+                t.generation++;  // The last state's timer must not fire into this one
+                send_keys(t, now);
+            }
+            break;
+    }
+}
+
+void launch_pipeline::send_keys(task& t, uint64_t now) {
+    const launch_step& step = t.steps[t.step];
+    while (t.key < step.keys.size()) {
+        uint16_t vk = step.keys[t.key];
+        if (!windows.post_key(t.result.window, vk, !t.key_down)) {
+            fail(t, step_name(t) + " lost its window", now);
+            return;
+        }
+        t.key_down = !t.key_down;
+        if (!t.key_down) {
+            t.key++;
+        } else if (step.hold_ms > 0) {
+            enter_state(t, launch_state::sending_keys, now + uint64_t{step.hold_ms} * 1'000'000);
+            return;
+        }
+    }
+    t.step++;
+    begin_step(t, now);
+}
+
+void launch_pipeline::enter_state(task& t, launch_state state, uint64_t deadline_ns) {
+    t.result.state = state;
+    t.generation++;
+    timers.schedule(deadline_ns, timer{static_cast<size_t>(&t - tasks.data()), t.generation});
+}
+
+std::string launch_pipeline::step_name(const task& t) const {
+    std::string name = "step " + std::to_string(t.step + 1) + "/" + std::to_string(t.steps.size());
+    if (t.step < t.steps.size()) {
+        const launch_step& step = t.steps[t.step];
+        name += std::string(" (") + launch_step_type_name(step.type);
+        if (!step.pattern.empty()) {
+            name += " \"" + step.pattern + "\"";
+        }
+        name += ")";
+    }
+    return name;
+}
+
+void launch_pipeline::finish(task& t, uint64_t now) {
+    t.result.state = launch_state::ready;
+    t.result.elapsed_ns = now - t.started_ns;
+    t.generation++;
+    pending--;
+    LOG_INFO("{} instance {} ready after {}ms", t.result.spec.id, t.result.spec.instance,
+             t.result.elapsed_ns / 1'000'000);
+}
+
+void launch_pipeline::fail(task& t, const std::string& error, uint64_t now) {
+    t.result.state = launch_state::failed;
+    t.result.error = error;
+    t.result.elapsed_ns = now - t.started_ns;
+    t.result.window = nullptr;
+    t.generation++;
+    windows.terminate(t.result.process);
+    pending--;
+    LOG_ERROR("Launch of {} instance {} failed: {}", t.result.spec.id, t.result.spec.instance, error);
+}
+
+void launch_pipeline::rescan(uint64_t now) {
+    // Covers events the window system missed, e.g. from elevated processes.
+    // The registry only fetches windows it has not seen yet.
+    registry_diff diff = registry.refresh();
+    for (window_handle handle : diff.added) {
+        const window_info* info = registry.find(handle);
+        if (!info) {
+            continue;
+        }
+        task* t = task_of(info->pid);
+        if (!t) {
+            t = claim_by_title(handle, info->pid);
+        }
+        if (t) {
+            t->alive.insert(handle);
+            consider(*t, handle, now);
+        }
+    }
+}
+
+std::vector<launch_step> default_launch_steps(int window_sequence) {
+    std::vector<launch_step> steps;
+    for (int i = 1; i <= window_sequence; ++i) {
+        steps.push_back(launch_step{});
+        if (i < window_sequence) {
+            launch_step enter;
+            enter.type = launch_step_type::send_keys;
+            enter.keys = {VK_ENTER};
+            enter.delay_ms = ENTER_DELAY_MS;
+            enter.hold_ms = ENTER_HOLD_MS;
+            steps.push_back(enter);
+        }
+    }
+    return steps;
+}
+
+const char* launch_state_name(launch_state state) {
+    switch (state) {
+        case launch_state::waiting_title: return "waiting_title";
+        case launch_state::sending_keys: return "sending_keys";
+        case launch_state::ready: return "ready";
+        case launch_state::failed: return "failed";
+        case launch_state::waiting_window:
+        default: return "waiting_window";
+    }
+}
+
+bool parse_launch_step_type(const std::string& name, launch_step_type& type) {
+    if (name == "wait_window") {
+        type = launch_step_type::wait_window;
+    } else if (name == "wait_title") {
+        type = launch_step_type::wait_title;
+    } else if (name == "send_keys") {
+        type = launch_step_type::send_keys;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* launch_step_type_name(launch_step_type type) {
+    switch (type) {
+        case launch_step_type::wait_title: return "wait_title";
+        case launch_step_type::send_keys: return "send_keys";
+        case launch_step_type::wait_window:
+        default: return "wait_window";
+    }
+}
@@ -0,0 +1,265 @@
+#include "logger.h"
+#include "timing.h"
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <queue>
+
+namespace {
+constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(5);
+
+const char* level_tag(log_level level) {
+    switch (level) {
+        case log_level::trace: return "TRACE";
+        case log_level::debug: return "DEBUG";
+        case log_level::info: return "INFO ";
+        case log_level::warn: return "WARN ";
+        case log_level::error: return "ERROR";
+        default: return "     ";
+    }
+}
+}
+
+log_record* log_buffer::begin_write() {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) >= CAPACITY) {
+        return nullptr;
+    }
+    log_record* record = &records[t % CAPACITY];
+    record->timestamp_ns = now_ns();
+    record->thread_index = thread_index;
+    return record;
+}
+
+void log_buffer::commit_write() {
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+size_t log_buffer::readable() const {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed);
+}
+
+logger::logger() : output(&std::cout) {}
+
+logger::~logger() {
+    stop();
+}
+
+void logger::start() {
+    if (running.exchange(true)) {
+        return;
+    }
+    start_ns = now_ns();
+    worker = std::thread(&logger::run, this);
+}
+
+void logger::stop() {
+    if (running.exchange(false)) {
+        wake_cv.notify_one();
+        worker.join();
+    }
+    // Whatever is left, including records written before start()
+    std::string out;
+    while (drain(out)) {
+        *output << out;
+        out.clear();
+    }
+    output->flush();
+    reclaim_retired();
+}
+
+log_buffer& logger::thread_buffer() {
+    // Hands the buffer back when the thread exits, the logger frees it
+    // once its last records are written out
+    struct owner {
+        std::shared_ptr<log_buffer> buffer;
+        ~owner() {
+            if (buffer) {
+                buffer->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+    thread_local owner thread_owner;
+    if (!thread_owner.buffer) {
+        thread_owner.buffer = std::make_shared<log_buffer>(next_thread_index.fetch_add(1));
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        buffers.push_back(thread_owner.buffer);
+    }
+    return *thread_owner.buffer;
+}
+
+void logger::reclaim_retired() {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    auto drained = [this](const std::shared_ptr<log_buffer>& buffer) {
+        // Retired first: its thread wrote nothing after setting it
+        if (!buffer->retired.load(std::memory_order_acquire) || buffer->readable() > 0) {
+            return false;
+        }
+        retired_dropped.fetch_add(buffer->dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return true;
+    };
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(), drained), buffers.end());
+}
+
+size_t logger::thread_buffers() const {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    return buffers.size();
+}
+
+uint64_t logger::dropped_records() const {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    uint64_t total = retired_dropped.load(std::memory_order_relaxed);
+    for (const auto& buffer : buffers) {
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void logger::run() {
+    std::string out;
+    out.reserve(64 * 1024);
+    while (running) {
+        if (drain(out)) {
+            *output << out;
+            output->flush();
+            out.clear();
+            reclaim_retired();
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake_cv.wait_for(lock, FLUSH_INTERVAL);
+    }
+}
+
+bool logger::drain(std::string& out) {
+    std::vector<std::shared_ptr<log_buffer>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        snapshot = buffers;
+    }
+    // Each buffer is in timestamp order, so a k-way merge over what they
+    // hold right now interleaves the threads. Later records wait for the
+    // next drain, a busy thread cannot keep this one going.
+    using head = std::pair<uint64_t, size_t>;  // Timestamp of the oldest record, buffer
+    std::priority_queue<head, std::vector<head>, std::greater<head>> heads;
+    std::vector<size_t> remaining(snapshot.size());
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        remaining[i] = snapshot[i]->readable();
+        if (remaining[i] > 0) {
+            heads.push({snapshot[i]->front().timestamp_ns, i});
+        }
+    }
+    bool any = !heads.empty();
+    while (!heads.empty()) {
+        size_t i = heads.top().second;
+        heads.pop();
+        format_record(snapshot[i]->front(), start_ns, out);
+        snapshot[i]->pop();
+        if (--remaining[i] > 0) {
+            heads.push({snapshot[i]->front().timestamp_ns, i});
+        }
+    }
+    return any;
+}
+
+void logger::capture_string(log_record& record, const char* value, size_t length) {
+    if (record.arg_count >= log_record::MAX_ARGS) {
+        return;
+    }
+    size_t space = log_record::TEXT_CAPACITY - record.text_used;
+    length = std::min(length, space);
+    log_arg& arg = record.args[record.arg_count++];
+    arg.type = log_arg::kind::string;
+    arg.str.offset = record.text_used;
+    arg.str.length = static_cast<uint16_t>(length);
+    std::memcpy(record.text + record.text_used, value, length);
+    record.text_used = static_cast<uint16_t>(record.text_used + length);
+}
+
+void logger::format_record(const log_record& record, uint64_t start_ns, std::string& out) {
+    char prefix[48];
+    double seconds = record.timestamp_ns > start_ns
+        ? static_cast<double>(record.timestamp_ns - start_ns) / 1e9 : 0.0;
+    std::snprintf(prefix, sizeof(prefix), "[%11.6f] [%s] ", seconds, level_tag(record.level));
+    out += prefix;
+
+    int next_arg = 0;
+    for (const char* p = record.format; *p; ++p) {
+        bool plain = p[0] == '{' && p[1] == '}';
+        bool hex = std::strncmp(p, "{:x}", 4) == 0;
+        if (!(plain || hex)) {
+            out += *p;
+            continue;
+        }
+        p += plain ? 1 : 3;
+        if (next_arg >= record.arg_count) {
+            out += "{}";
+            continue;
+        }
+        const log_arg& arg = record.args[next_arg++];
+        char number[32];
+        switch (arg.type) {
+            case log_arg::kind::signed_int:
+                std::snprintf(number, sizeof(number), hex ? "%llx" : "%lld", static_cast<long long>(arg.i));
+                out += number;
+                break;
+            case log_arg::kind::unsigned_int:
+                std::snprintf(number, sizeof(number), hex ? "%llx" : "%llu", static_cast<unsigned long long>(arg.u));
+                out += number;
+                break;
+            case log_arg::kind::floating:
+                std::snprintf(number, sizeof(number), "%g", arg.d);
+                out += number;
+                break;
+            case log_arg::kind::boolean:
+                out += arg.b ? "true" : "false";
+                break;
+            case log_arg::kind::character:
+                out += arg.c;
+                break;
+            case log_arg::kind::pointer:
+                std::snprintf(number, sizeof(number), "%llx",
+                              static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(arg.p)));
+                out += number;
+                break;
+            case log_arg::kind::string:
+                out.append(record.text + arg.str.offset, arg.str.length);
+                break;
+        }
+    }
+    out += '\n';
+}
+
+namespace {
+const struct {
+    const char* name;
+    log_level level;
+} LOG_LEVELS[] = {
+    {"trace", log_level::trace},
+    {"debug", log_level::debug},
+    {"info", log_level::info},
+    {"warn", log_level::warn},
+    {"error", log_level::error},
+    {"off", log_level::off}
+};
+}
+
+bool parse_log_level(const std::string& name, log_level& level) {
+    for (const auto& entry : LOG_LEVELS) {
+        if (name == entry.name) {
+            level = entry.level;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* log_level_name(log_level level) {
+    for (const auto& entry : LOG_LEVELS) {
+        if (entry.level == level) {
+            return entry.name;
+        }
+    }
+    return "unknown";
+}
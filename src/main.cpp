@@ -1,6 +1,8 @@
 #include "thread_manager.h"
 #include "settings_manager.h"
 #include "process_manager.h"
+#include "logger.h"
+#include "timing_service.h"
 #include <Windows.h>
 #include <iostream>
 #include <chrono>
@@ -19,6 +21,9 @@ int main() {
 
         // Print loaded settings for verification
         settings.printSettings();
+        logger::get_instance().set_level(settings.getLogLevel());
+        logger::get_instance().start();
+        LOG_INFO("Timing service spin margin: {}us", timing_service::get_instance().spin_margin_ns() / 1000);
         
         // Launch processes
         std::cout << "Launching processes...\n";
@@ -46,6 +51,13 @@ int main() {
         
         std::cout << "Starting threads...\n";
         manager.start_threads();
+
+        // Crashed or relogged clients are re-attached while everything else keeps running
+        if (!process_mgr.start_health_monitor([&manager](const std::string& process_id, int instance, HWND window) {
+                manager.retarget_input_sender_context(process_id, instance, window);
+            })) {
+            std::cerr << "Window health monitor not running, lost clients need a restart\n";
+        }
         
         while (true) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
@@ -56,8 +68,12 @@ int main() {
             }
         }
         
-        // Cleanup
+        // Cleanup. Senders release held keys and log while stopping, so the
+        // threads stop before the clients exit and the logger drains last.
+        process_mgr.stop_health_monitor();
+        manager.stop_threads();
         process_mgr.terminate_processes();
+        logger::get_instance().stop();
         return 0;
     }
     catch (const std::exception& e) {
@@ -0,0 +1,55 @@
+#include "message_channel.h"
+#include "mutex_channel.h"
+#include "spsc_channel.h"
+#include "broadcast_channel.h"
+
+bool message_channel::push(const message& msg) {
+    bool pushed = overflow.push([&]() { return try_push(msg); },
+                                [&]() { return coalesce_newest(msg); },
+                                [&]() { return evict_oldest(); });
+    if (pushed) {
+        overflow.record_size(size());
+    }
+    return pushed;
+}
+
+std::shared_ptr<message_channel> make_message_channel(channel_type type, size_t capacity,
+                                                      const wait_config& wait) {
+    switch (type) {
+        case channel_type::spsc_ring:
+            return std::make_shared<spsc_channel>(capacity, wait);
+        case channel_type::broadcast_ring: {
+            // A private ring with a single reader; shared rings are built by thread_manager
+            auto ring = std::make_shared<broadcast_ring>(capacity, wait);
+            return std::make_shared<broadcast_channel>(ring, ring->add_reader());
+        }
+        case channel_type::mutex_queue:
+        default:
+            return std::make_shared<mutex_channel>(capacity, wait);
+    }
+}
+
+bool parse_channel_type(const std::string& name, channel_type& type) {
+    if (name == "mutex") {
+        type = channel_type::mutex_queue;
+        return true;
+    }
+    if (name == "spsc") {
+        type = channel_type::spsc_ring;
+        return true;
+    }
+    if (name == "broadcast") {
+        type = channel_type::broadcast_ring;
+        return true;
+    }
+    return false;
+}
+
+const char* channel_type_name(channel_type type) {
+    switch (type) {
+        case channel_type::spsc_ring: return "spsc";
+        case channel_type::broadcast_ring: return "broadcast";
+        case channel_type::mutex_queue:
+        default: return "mutex";
+    }
+}
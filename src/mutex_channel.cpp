@@ -0,0 +1,84 @@
+#include "mutex_channel.h"
+
+mutex_channel::mutex_channel(size_t capacity, const wait_config& wait)
+    : max_size(capacity), waiter(wait) {}
+
+bool mutex_channel::try_push(const message& msg) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (messages.size() >= max_size) {
+        return false;
+    }
+    messages.push_back(msg);
+    count.store(messages.size(), std::memory_order_release);
+    lock.unlock();
+    waiter.notify();
+    return true;
+}
+
+bool mutex_channel::try_push_batch(const std::vector<message>& batch) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (messages.size() + batch.size() > max_size) {
+        return false;
+    }
+    for (const auto& msg : batch) {
+        messages.push_back(msg);
+    }
+    count.store(messages.size(), std::memory_order_release);
+    lock.unlock();
+    waiter.notify();
+    return true;
+}
+
+bool mutex_channel::try_pop(message& msg) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (messages.empty()) {
+        return false;
+    }
+    msg = std::move(messages.front());
+    messages.pop_front();
+    count.store(messages.size(), std::memory_order_release);
+    return true;
+}
+
+size_t mutex_channel::try_pop_batch(std::vector<message>& out, size_t max_messages) {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t batch_size = std::min(max_messages, messages.size());
+    for (size_t i = 0; i < batch_size; ++i) {
+        out.push_back(std::move(messages.front()));
+        messages.pop_front();
+    }
+    count.store(messages.size(), std::memory_order_release);
+    return batch_size;
+}
+
+bool mutex_channel::coalesce_newest(const message& msg) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !messages.empty() && coalescible(messages.back(), msg);
+}
+
+bool mutex_channel::evict_oldest() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (messages.size() < max_size) {
+        return false;  // The consumer made room meanwhile
+    }
+    messages.pop_front();
+    count.store(messages.size(), std::memory_order_release);
+    return true;
+}
+
+void mutex_channel::wait_for_messages(const std::atomic<bool>& running) {
+    waiter.wait([this]() { return count.load(std::memory_order_acquire) > 0; }, running);
+}
+
+bool mutex_channel::wait_for_messages_until(const std::atomic<bool>& running, uint64_t deadline_ns) {
+    return waiter.wait_until([this]() { return count.load(std::memory_order_acquire) > 0; },
+                             running, deadline_ns);
+}
+
+void mutex_channel::wake_all() {
+    waiter.notify_all();
+}
+
+size_t mutex_channel::size() const {
+    return count.load(std::memory_order_acquire);
+}
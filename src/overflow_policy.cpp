@@ -0,0 +1,26 @@
+#include "overflow_policy.h"
+
+bool parse_overflow_policy(const std::string& name, overflow_policy& policy) {
+    if (name == "drop_newest") {
+        policy = overflow_policy::drop_newest;
+    } else if (name == "drop_oldest") {
+        policy = overflow_policy::drop_oldest;
+    } else if (name == "block") {
+        policy = overflow_policy::block;
+    } else if (name == "coalesce") {
+        policy = overflow_policy::coalesce;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* overflow_policy_name(overflow_policy policy) {
+    switch (policy) {
+        case overflow_policy::drop_oldest: return "drop_oldest";
+        case overflow_policy::block: return "block";
+        case overflow_policy::coalesce: return "coalesce";
+        case overflow_policy::drop_newest:
+        default: return "drop_newest";
+    }
+}
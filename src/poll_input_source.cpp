@@ -0,0 +1,53 @@
+#include "poll_input_source.h"
+#include "timing.h"
+
+bool poll_input_source::start() {
+    // Keys already held at startup are not reported as fresh presses
+    for (int vk = 0; vk < 256; ++vk) {
+        key_state[vk] = (GetAsyncKeyState(vk) & 0x8000) != 0;
+    }
+    pending.clear();
+    pending_index = 0;
+    running = true;
+    return true;
+}
+
+bool poll_input_source::next_event(input_event& event, uint64_t deadline_ns) {
+    while (running) {
+        if (pending_index < pending.size()) {
+            event = pending[pending_index++];
+            return true;
+        }
+        pending.clear();
+        pending_index = 0;
+
+        scan();
+        if (!pending.empty()) {
+            continue;
+        }
+        if (deadline_ns != NO_DEADLINE && now_ns() >= deadline_ns) {
+            return false;
+        }
+        Sleep(1);
+    }
+    return false;
+}
+
+void poll_input_source::scan() {
+    uint64_t scanned_ns = now_ns();
+    for (int vk = 0; vk < 256; ++vk) {
+        // Report modifiers by side only, like the keyboard hook does
+        if (vk == VK_SHIFT || vk == VK_CONTROL || vk == VK_MENU) {
+            continue;
+        }
+        bool down = (GetAsyncKeyState(vk) & 0x8000) != 0;
+        if (down != key_state[vk]) {
+            key_state[vk] = down;
+            input_event event;
+            event.vk_code = static_cast<uint16_t>(vk);
+            event.key_down = down;
+            event.timestamp_ns = scanned_ns;
+            pending.push_back(event);
+        }
+    }
+}
@@ -1,7 +1,11 @@
 #include "process_manager.h"
+#include "launch_pipeline.h"
+#include "win32_window_system.h"
 #include <iostream>
-#include <sstream>
-#include <filesystem>
+
+ProcessManager::ProcessManager()
+    : window_system(std::make_unique<win32_window_system>())
+    , registry(*window_system) {}
 
 bool ProcessManager::launch_processes() {
     const auto& configs = SettingsManager::getInstance().getProcessConfigs();
@@ -31,8 +35,8 @@ bool ProcessManager::launch_processes() {
         }
     }
     
-    // Launch remaining instances if auto_launch is enabled
-    bool launch_success = true;
+    // Launch remaining instances if auto_launch is enabled, all at once
+    std::vector<launch_spec> specs;
     for (const auto& config : configs) {
         if (remaining_instances.count(config.id) > 0 && config.auto_launch) {
             std::cout << "Auto-launching " << remaining_instances[config.id] 
@@ -46,14 +50,42 @@ bool ProcessManager::launch_processes() {
             }
             
             for (int i = 0; i < remaining_instances[config.id]; ++i) {
-                if (!launchProcess(config, current_instances + i)) {
-                    launch_success = false;
-                    std::cerr << "Failed to launch process " << config.id 
-                             << " instance " << (current_instances + i) << "\n";
-                }
+                specs.push_back(launch_spec{config.id, current_instances + i, config.executable_path,
+                                            config.args, config.window_sequence, config.launch_steps});
             }
         }
     }
+    if (specs.empty()) {
+        return true;
+    }
+
+    if (!window_system->start()) {
+        std::cerr << "Failed to watch for new windows, cannot launch processes\n";
+        return false;
+    }
+    launch_pipeline pipeline(*window_system, registry);
+    auto results = pipeline.run(specs);
+    window_system->stop();
+
+    bool launch_success = true;
+    for (auto& result : results) {
+        if (result.state != launch_state::ready) {
+            launch_success = false;
+            std::cerr << "Failed to launch process " << result.spec.id 
+                     << " instance " << result.spec.instance << ": " << result.error << "\n";
+            continue;
+        }
+        std::cout << "Launched " << result.spec.id << " instance " << result.spec.instance
+                  << " in " << result.elapsed_ns / 1'000'000 << "ms: " << result.title << "\n";
+        registry.attach(window_key{result.spec.id, result.spec.instance}, result.window);
+        process_instances.push_back(ProcessInstance{
+            static_cast<HANDLE>(result.process.handle),
+            static_cast<HWND>(result.window),
+            result.spec.id,
+            result.spec.instance,
+            result.title
+        });
+    }
     
     return launch_success;
 }
@@ -62,13 +94,45 @@ bool ProcessManager::scan_and_attach_windows() {
     process_instances.clear();
     const auto& configs = SettingsManager::getInstance().getProcessConfigs();
     
+    if (!build_matcher()) {
+        return false;
+    }
+
     // Map to track instance counts for each process ID
     std::unordered_map<std::string, int> instance_counts;
     
-    // Get all visible windows
-    std::vector<WindowInfo> windows;
-    EnumWindowsCallbackArgs args{windows, configs, instance_counts};
-    EnumWindows(enumWindowCallback, reinterpret_cast<LPARAM>(&args));
+    // Get all visible windows, only ones the registry has not seen are fetched
+    registry.refresh();
+    for (window_handle handle : registry.z_order()) {
+        const window_info* window = registry.find(handle);
+        // Skip empty titles
+        if (!window || window->title.empty()) {
+            continue;
+        }
+        
+        // One pass over the title finds the best matching process, if any
+        int index = matcher.match(window->title);
+        if (index < 0) {
+            continue;
+        }
+        const ProcessConfig& config = configs[index];
+        // Only store if we haven't exceeded desired instances
+        int current_instance = instance_counts[config.id]++;
+        if (current_instance < config.instances) {
+            registry.attach(window_key{config.id, current_instance}, handle);
+            process_instances.push_back(ProcessInstance{
+                nullptr,  // No process handle for attached windows
+                static_cast<HWND>(handle),
+                config.id,
+                current_instance,
+                window->title
+            });
+            
+            std::cout << "Found window for " << config.id 
+                      << " instance " << current_instance 
+                      << ": " << window->title << "\n";
+        }
+    }
     
     // Check if we found all required instances
     bool all_found = true;
@@ -86,241 +150,95 @@ bool ProcessManager::scan_and_attach_windows() {
     return all_found;
 }
 
-BOOL CALLBACK ProcessManager::enumWindowCallback(HWND handle, LPARAM param) {
-    auto* args = reinterpret_cast<EnumWindowsCallbackArgs*>(param);
-    
-    // Check if window is visible
-    if (!IsWindowVisible(handle)) {
-        return TRUE;
+bool ProcessManager::build_matcher() {
+    if (matcher.size() > 0) {
+        return true;
     }
-    
-    // Get window title and class
-    char title[256] = "";
-    char class_name[256] = "";
-    GetWindowTextA(handle, title, sizeof(title));
-    GetClassNameA(handle, class_name, sizeof(class_name));
-    
-    std::string window_title(title);
-    
-    // Skip empty titles
-    if (window_title.empty()) {
-        return TRUE;
+    const auto& configs = SettingsManager::getInstance().getProcessConfigs();
+    for (size_t i = 0; i < configs.size(); ++i) {
+        matcher.add(configs[i].title_pattern, configs[i].match, static_cast<int>(i));
     }
-    
-    // Check each process configuration
-    for (const auto& config : args->configs) {
-        // Check if window title contains the process ID
-        if (window_title.find(config.id) != std::string::npos) {
-            // Get current instance count
-            int current_instance = args->instance_counts[config.id]++;
-            
-            // Only store if we haven't exceeded desired instances
-            if (current_instance < config.instances) {
-                WindowInfo info{
-                    handle,
-                    window_title,
-                    class_name
-                };
-                args->windows.push_back(info);
-                
-                // Store the process instance
-                ProcessInstance instance{
-                    nullptr,  // No process handle for attached windows
-                    handle,
-                    config.id,
-                    current_instance,
-                    window_title
-                };
-                ProcessManager::getInstance().process_instances.push_back(instance);
-                
-                std::cout << "Found window for " << config.id 
-                          << " instance " << current_instance 
-                          << ": " << window_title << "\n";
-            }
-        }
+    if (!matcher.compile()) {
+        std::cerr << "Failed to compile window title patterns\n";
+        return false;
     }
-    
-    return TRUE;
+    return true;
 }
 
-bool ProcessManager::launchProcess(const ProcessConfig& config, int instance_num) {
-    std::cout << "Launching process: " << config.id 
-              << " instance " << instance_num 
-              << " path: " << config.executable_path 
-              << " window_sequence: " << config.window_sequence << "\n";
-
-    auto base_windows = getAllWindows();
-
-    STARTUPINFOW si = {};
-    si.cb = sizeof(STARTUPINFOW);
-    si.dwFlags = STARTF_USESHOWWINDOW;
-    si.wShowWindow = SW_SHOW;
-
-    PROCESS_INFORMATION pi = {};
-
-    std::filesystem::path exePath(config.executable_path);
-    std::wstring wide_path = exePath.wstring();
-    std::wstring workingDir = exePath.parent_path().wstring();
-
-    std::string cmd_line = "\"" + config.executable_path + "\"";
-    for (const auto& arg : config.args) {
-        cmd_line += " \"" + arg + "\"";
-    }
-    std::wstring wide_cmd_line(cmd_line.begin(), cmd_line.end());
+HWND ProcessManager::get_window_handle(const std::string& process_id, int instance) const {
+    return static_cast<HWND>(registry.attached(window_key{process_id, instance}));
+}
 
-    if (!CreateProcessW(
-            wide_path.c_str(),
-            wide_cmd_line.empty() ? nullptr : &wide_cmd_line[0],
-            nullptr,
-            nullptr,
-            FALSE,
-            CREATE_DEFAULT_ERROR_MODE,
-            nullptr,
-            workingDir.c_str(),
-            &si,
-            &pi)) {
-        DWORD error = GetLastError();
-        std::cerr << "Failed to create process. Error: " << error << "\n";
+bool ProcessManager::start_health_monitor(window_replaced_listener listener) {
+    if (health_monitor || !build_matcher()) {
         return false;
     }
-
-    // Wait for process to initialize
-    WaitForInputIdle(pi.hProcess, 5000);
-
-    HWND target_window = nullptr;
-    
-    for (int sequence = 1; sequence <= config.window_sequence; sequence++) {
-        bool window_found = false;
-        
-        for (int attempt = 0; attempt < 60 && !window_found; attempt++) {
-            if (attempt % 5 == 0) {
-                std::cout << "Searching for window sequence " << sequence 
-                          << ", attempt " << (attempt + 1) << "\n";
-            }
-            
-            target_window = findNewWindow(base_windows);
-            if (target_window) {
-                window_found = true;
-                
-                if (sequence < config.window_sequence) {
-                    std::cout << "Sending Enter key to window " << sequence << "\n";
-                    Sleep(500);
-                    PostMessage(target_window, WM_KEYDOWN, VK_RETURN, 0x001C0001);
-                    Sleep(100);
-                    PostMessage(target_window, WM_KEYUP, VK_RETURN, 0xC01C0001);
-                    Sleep(2000);
-                }
-                
-                // Update base windows for next sequence
-                base_windows = getAllWindows();
-            }
-            
-            if (!window_found) {
-                Sleep(1000);
-            }
-        }
-        
-        if (!window_found) {
-            std::cerr << "Failed to find window " << sequence << " in sequence\n";
-            TerminateProcess(pi.hProcess, 0);
-            CloseHandle(pi.hProcess);
-            CloseHandle(pi.hThread);
-            return false;
-        }
+    const auto& configs = SettingsManager::getInstance().getProcessConfigs();
+    health_monitor = std::make_unique<window_health_monitor>(*window_system, registry, matcher,
+                                                             SettingsManager::getInstance().getHealthConfig());
+    for (const auto& instance : process_instances) {
+        int index = SettingsManager::getInstance().findProcessIndex(instance.id);
+        const ProcessConfig& config = configs[index];
+        health_monitor->add_client(monitored_client{
+            launch_spec{config.id, instance.instance_number, config.executable_path,
+                        config.args, config.window_sequence, config.launch_steps},
+            index,
+            config.auto_launch
+        });
     }
-
-    if (!target_window) {
-        std::cerr << "Failed to get target window\n";
-        TerminateProcess(pi.hProcess, 0);
-        CloseHandle(pi.hProcess);
-        CloseHandle(pi.hThread);
+    replaced_listener = std::move(listener);
+    health_monitor->set_handler([this](const monitored_client& client, window_handle window,
+                                       const launched_process& process) {
+        on_window_replaced(client, window, process);
+    });
+    if (!health_monitor->start()) {
+        health_monitor.reset();
         return false;
     }
-
-    // Store the process information
-    ProcessInstance instance{
-        pi.hProcess,
-        target_window,
-        config.id,
-        instance_num,
-        ""  // Window title will be fetched when needed
-    };
-    
-    // Get the window title
-    char title[256] = "";
-    GetWindowTextA(target_window, title, sizeof(title));
-    instance.window_title = title;
-    
-    process_instances.push_back(instance);
-
-    CloseHandle(pi.hThread);
     return true;
 }
 
-std::vector<WindowInfo> ProcessManager::getAllWindows() const {
-    std::vector<WindowInfo> windows;
-    EnumWindows(enumWindowCallbackBasic, reinterpret_cast<LPARAM>(&windows));
-    return windows;
-}
-
-BOOL CALLBACK ProcessManager::enumWindowCallbackBasic(HWND handle, LPARAM param) {
-    auto* windows = reinterpret_cast<std::vector<WindowInfo>*>(param);
-    
-    if (!IsWindowVisible(handle)) {
-        return TRUE;
+void ProcessManager::stop_health_monitor() {
+    if (health_monitor) {
+        health_monitor->stop();
+        health_monitor->print_metrics();
+        health_monitor.reset();
     }
-    
-    char title[256] = "";
-    char class_name[256] = "";
-    GetWindowTextA(handle, title, sizeof(title));
-    GetClassNameA(handle, class_name, sizeof(class_name));
-    
-    WindowInfo info{
-        handle,
-        title,
-        class_name
-    };
-    
-    windows->push_back(info);
-    return TRUE;
 }
 
-HWND ProcessManager::findNewWindow(const std::vector<WindowInfo>& before_windows) const {
-    auto current_windows = getAllWindows();
-    
-    for (const auto& current : current_windows) {
-        bool is_new = true;
-        for (const auto& before : before_windows) {
-            if (current.handle == before.handle) {
-                is_new = false;
-                break;
-            }
+void ProcessManager::on_window_replaced(const monitored_client& client, window_handle window,
+                                        const launched_process& process) {
+    // Monitor thread. process_instances is left alone by everything else
+    // until the monitor stops.
+    for (auto& instance : process_instances) {
+        if (instance.id != client.spec.id || instance.instance_number != client.spec.instance) {
+            continue;
         }
-        
-        if (is_new && !current.title.empty()) {
-            std::cout << "Found new window: " << current.title << "\n";
-            return current.handle;
+        instance.window_handle = static_cast<HWND>(window);
+        instance.window_title = window_system->window_title(window);
+        if (process.handle) {
+            // Relaunched, the old client is given up on
+            if (instance.process_handle) {
+                TerminateProcess(instance.process_handle, 0);
+                CloseHandle(instance.process_handle);
+            }
+            instance.process_handle = static_cast<HANDLE>(process.handle);
         }
+        break;
     }
-    
-    return nullptr;
-}
-
-HWND ProcessManager::get_window_handle(const std::string& process_id, int instance) const {
-    for (const auto& proc : process_instances) {
-        if (proc.id == process_id && proc.instance_number == instance) {
-            return proc.window_handle;
-        }
+    if (replaced_listener) {
+        replaced_listener(client.spec.id, client.spec.instance, static_cast<HWND>(window));
     }
-    return nullptr;
 }
 
 void ProcessManager::terminate_processes() {
+    stop_health_monitor();
     for (const auto& instance : process_instances) {
         if (instance.process_handle) {  // Only terminate processes we launched
             TerminateProcess(instance.process_handle, 0);
             CloseHandle(instance.process_handle);
         }
+        registry.detach(window_key{instance.id, instance.instance_number});
     }
     process_instances.clear();
 }
\ No newline at end of file
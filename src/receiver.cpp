@@ -1,5 +1,5 @@
 #include "receiver.h"
-#include <iostream>
+#include "logger.h"
 #include <chrono>
 #include <thread>
 
@@ -7,55 +7,54 @@ receiver::receiver(std::shared_ptr<message_channel> channel, std::atomic<bool>&
     : channel(channel), running(running) {}
 
 std::optional<message> receiver::receive_message() {
-    std::unique_lock<std::mutex> lock(channel->mutex);
+    message msg;
     
     // Wait for a message or shutdown
-    channel->cv.wait(lock, [this]() {
-        return !channel->messages.empty() || !running;
-    });
-    
-    if (channel->messages.empty()) {
-        return std::nullopt;
+    while (!channel->try_pop(msg)) {
+        if (!running) {
+            return std::nullopt;
+        }
+        channel->wait_for_messages(running);
     }
-    
-    message msg = std::move(channel->messages.front());
-    channel->messages.pop();
-    lock.unlock();
-    channel->cv.notify_one();
     return msg;
 }
 
+std::optional<message> receiver::receive_message_until(uint64_t deadline_ns) {
+    message msg;
+    if (channel->try_pop(msg) ||
+        (running && channel->wait_for_messages_until(running, deadline_ns) && channel->try_pop(msg))) {
+        return msg;
+    }
+    return std::nullopt;
+}
+
 std::vector<message> receiver::receive_batch(size_t max_messages) {
     std::vector<message> batch;
-    std::unique_lock<std::mutex> lock(channel->mutex);
     
     // Wait until there are messages or we're no longer running
-    channel->cv.wait(lock, [this]() { 
-        return !channel->messages.empty() || !running; 
-    });
-    
-    if (!running && channel->messages.empty()) {
-        return batch;
-    }
-    
-    size_t batch_size = std::min(max_messages, channel->messages.size());
-    batch.reserve(batch_size);
-    
-    for (size_t i = 0; i < batch_size; ++i) {
-        batch.push_back(std::move(channel->messages.front()));
-        channel->messages.pop();
+    while (channel->try_pop_batch(batch, max_messages) == 0) {
+        if (!running) {
+            return batch;
+        }
+        channel->wait_for_messages(running);
     }
     
     return batch;
 }
 
+size_t receiver::receive_batch_until(std::vector<message>& out, size_t max_messages, uint64_t deadline_ns) {
+    size_t received = channel->try_pop_batch(out, max_messages);
+    if (received == 0 && running && channel->wait_for_messages_until(running, deadline_ns)) {
+        received = channel->try_pop_batch(out, max_messages);
+    }
+    return received;
+}
+
 void receiver::operator()() {
-    while (running || !channel->messages.empty()) {
+    while (running || channel->size() > 0) {
         auto batch = receive_batch(BATCH_SIZE);
         for (const auto& msg : batch) {
-            std::cout << "Received command: " << msg.m_command 
-                     << " msg_id: " << msg.m_msg_id 
-                     << " message: " << msg.m_msg << std::endl;
+            LOG_DEBUG("Received command: {} msg_id: {}", msg.m_command, msg.m_msg_id);
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "recording_injector.h"
+#include "timing.h"
+#include <chrono>
+#include <thread>
+
+bool recording_injector::key_down(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) {
+    return record(window, vk_code, scan_code, extended, true);
+}
+
+bool recording_injector::key_up(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) {
+    return record(window, vk_code, scan_code, extended, false);
+}
+
+size_t recording_injector::inject(window_handle window, const key_transition* keys, size_t count) {
+    if (count == 0 || !respond()) {
+        return 0;
+    }
+    uint64_t timestamp = now_ns();
+    std::lock_guard<std::mutex> lock(keys_mutex);
+    for (size_t i = 0; i < count; ++i) {
+        recorded.push_back(injected_key{window, keys[i].vk_code, keys[i].scan_code,
+                                        keys[i].extended, keys[i].down, timestamp});
+    }
+    return count;
+}
+
+bool recording_injector::probe(window_handle window) {
+    (void)window;
+    return respond();
+}
+
+bool recording_injector::respond() {
+    uint64_t delay_ns = response_delay_ns.load(std::memory_order_relaxed);
+    uint64_t timeout_ns = uint64_t{call_timeout_ms} * 1'000'000;
+    if (delay_ns == 0) {
+        error = inject_error::none;
+        return true;
+    }
+    if (timeout_ns != 0 && delay_ns > timeout_ns) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(timeout_ns));
+        error = inject_error::timeout;
+        return false;
+    }
+    std::this_thread::sleep_for(std::chrono::nanoseconds(delay_ns));
+    error = inject_error::none;
+    return true;
+}
+
+std::vector<injected_key> recording_injector::keys() const {
+    std::lock_guard<std::mutex> lock(keys_mutex);
+    return recorded;
+}
+
+void recording_injector::clear() {
+    std::lock_guard<std::mutex> lock(keys_mutex);
+    recorded.clear();
+}
+
+bool recording_injector::record(window_handle window, uint16_t vk_code, uint16_t scan_code,
+                                bool extended, bool down) {
+    if (!respond()) {
+        return false;
+    }
+    injected_key key{window, vk_code, scan_code, extended, down, now_ns()};
+    std::lock_guard<std::mutex> lock(keys_mutex);
+    recorded.push_back(key);
+    return true;
+}
@@ -0,0 +1,102 @@
+#include "replay_input_source.h"
+#include "timing.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+replay_input_source::replay_input_source(std::string path, bool paced)
+    : path(std::move(path)), paced(paced) {}
+
+replay_input_source::replay_input_source(std::vector<input_event> events, bool paced)
+    : paced(paced), events(std::move(events)) {}
+
+bool replay_input_source::start() {
+    if (!path.empty()) {
+        events.clear();
+        if (!load_file(path, events)) {
+            return false;
+        }
+    }
+    std::stable_sort(events.begin(), events.end(), [](const input_event& a, const input_event& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+    next_index = 0;
+    start_ns = now_ns();
+    running = true;
+    return true;
+}
+
+void replay_input_source::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex);
+        running = false;
+    }
+    stop_cv.notify_all();
+}
+
+bool replay_input_source::next_event(input_event& event, uint64_t deadline_ns) {
+    std::unique_lock<std::mutex> lock(stop_mutex);
+    uint64_t due_ns = NO_DEADLINE;
+    if (!finished()) {
+        due_ns = paced ? start_ns + events[next_index].timestamp_ns : 0;
+    }
+    uint64_t wake_ns = std::min(due_ns, deadline_ns);
+    auto stopped = [this]() { return !running; };
+    if (wake_ns == NO_DEADLINE) {
+        stop_cv.wait(lock, stopped);
+    } else if (now_ns() < wake_ns) {
+        stop_cv.wait_until(lock, to_steady_time(wake_ns), stopped);
+    }
+
+    if (!running || finished() || now_ns() < due_ns) {
+        return false;
+    }
+    event = events[next_index++];
+    event.timestamp_ns = now_ns();
+    return true;
+}
+
+bool replay_input_source::load_file(const std::string& path, std::vector<input_event>& events) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Could not open replay file: " << path << "\n";
+        return false;
+    }
+
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        double offset_ms;
+        std::string direction;
+        std::string vk_text;
+        if (!(fields >> offset_ms)) {
+            continue;  // Blank or comment line
+        }
+        if (!(fields >> direction >> vk_text) || (direction != "down" && direction != "up")) {
+            std::cerr << "Malformed replay line " << line_number << " in " << path << "\n";
+            return false;
+        }
+
+        unsigned long vk = 0;
+        try {
+            vk = std::stoul(vk_text, nullptr, 0);
+        } catch (const std::exception&) {
+            vk = 256;
+        }
+        if (vk == 0 || vk > 255 || offset_ms < 0) {
+            std::cerr << "Invalid key or offset on replay line " << line_number << " in " << path << "\n";
+            return false;
+        }
+
+        input_event event;
+        event.vk_code = static_cast<uint16_t>(vk);
+        event.key_down = direction == "down";
+        event.timestamp_ns = static_cast<uint64_t>(offset_ms * 1e6);
+        events.push_back(event);
+    }
+    return true;
+}
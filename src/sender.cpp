@@ -8,27 +8,11 @@ sender::sender(std::shared_ptr<message_channel> channel, std::atomic<bool>& runn
     : channel(channel), running(running) {}
 
 bool sender::send_message(const message& msg) {
-    std::unique_lock<std::mutex> lock(channel->mutex);
-    if (channel->messages.size() >= channel->MAX_QUEUE_SIZE) {
-        return false;
-    }
-    channel->messages.push(msg);
-    lock.unlock();
-    channel->cv.notify_one();
-    return true;
+    return channel->push(msg);
 }
 
 bool sender::send_batch(const std::vector<message>& messages) {
-    std::unique_lock<std::mutex> lock(channel->mutex);
-    if (channel->messages.size() + messages.size() > channel->MAX_QUEUE_SIZE) {
-        return false;
-    }
-    for (const auto& msg : messages) {
-        channel->messages.push(msg);
-    }
-    lock.unlock();
-    channel->cv.notify_one();
-    return true;
+    return channel->try_push_batch(messages);
 }
 
 void sender::operator()() {
@@ -40,8 +24,7 @@ void sender::operator()() {
         batch.reserve(BATCH_SIZE);
 
         for (size_t i = 0; i < BATCH_SIZE && running && message_count < 1000000; ++i) {
-            // Updated to use new member names
-            batch.emplace_back(1, message_count, "Message " + std::to_string(message_count));
+            batch.emplace_back(message_command::text, static_cast<uint32_t>(message_count));
             message_count++;
         }
 
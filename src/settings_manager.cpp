@@ -1,4 +1,5 @@
 #include "settings_manager.h"
+#include "key_codes.h"
 #include <fstream>
 #include <iostream>
 #include <filesystem>
@@ -60,6 +61,46 @@ bool SettingsManager::loadSettings(const fs::path& filepath) {
         // Clear existing configurations
         process_configs.clear();
         key_bindings.clear();
+        channel_config = ChannelConfig{};
+        log_level_setting = log_level::info;
+
+        if (json.contains("log_level") &&
+            !parse_log_level(json["log_level"].get<std::string>(), log_level_setting)) {
+            std::cerr << "Unknown log_level: " << json["log_level"].get<std::string>() << "\n";
+            return false;
+        }
+
+        input_config = InputConfig{};
+        if (json.contains("input") && !parseInputConfig(json["input"], input_config)) {
+            return false;
+        }
+
+        execution_config = ExecutionConfig{};
+        if (json.contains("execution") && !parseExecutionConfig(json["execution"], execution_config)) {
+            return false;
+        }
+
+        health = health_config{};
+        if (json.contains("health") && !parseHealthConfig(json["health"], health)) {
+            return false;
+        }
+
+        key_hold_ms = json.value("key_hold_ms", DEFAULT_KEY_HOLD_MS);
+
+        default_injector = injector_type::send_message;
+        if (json.contains("injector") && !parseInjectorType(json["injector"], default_injector)) {
+            return false;
+        }
+
+        default_breaker = breaker_config{};
+        if (json.contains("breaker") && !parseBreakerConfig(json["breaker"], default_breaker)) {
+            return false;
+        }
+
+        // Default channel settings, may be overridden per process
+        if (json.contains("channel") && !parseChannelConfig(json["channel"], channel_config)) {
+            return false;
+        }
 
         // Parse process configurations
         for (const auto& proc : json["processes"]) {
@@ -67,27 +108,111 @@ bool SettingsManager::loadSettings(const fs::path& filepath) {
             config.id = proc["id"].get<std::string>();
             config.executable_path = proc["path"].get<std::string>();
             config.instances = proc["instances"].get<int>();
-            config.window_sequence = proc["window_sequence"].get<int>();
+            config.window_sequence = proc.value("window_sequence", 1);
+            config.auto_launch = proc.value("auto_launch", false);
+            if (config.window_sequence < 1) {
+                std::cerr << "Invalid window_sequence for " << config.id << ": " << config.window_sequence << "\n";
+                return false;
+            }
             
             if (proc.contains("args")) {
                 config.args = proc["args"].get<std::vector<std::string>>();
             }
+
+            if (!parseTitleMatch(proc, config)) {
+                return false;
+            }
+
+            if (proc.contains("launch")) {
+                if (proc["launch"].empty()) {
+                    std::cerr << "Empty launch script for " << config.id << "\n";
+                    return false;
+                }
+                for (const auto& step_json : proc["launch"]) {
+                    launch_step step;
+                    if (!parseLaunchStep(step_json, step)) {
+                        std::cerr << "Invalid launch step for " << config.id << ": " << step_json.dump() << "\n";
+                        return false;
+                    }
+                    config.launch_steps.push_back(step);
+                }
+            } else {
+                config.launch_steps = default_launch_steps(config.window_sequence);
+            }
+
+            config.channel = channel_config;
+            if (proc.contains("channel") && !parseChannelConfig(proc["channel"], config.channel)) {
+                return false;
+            }
+
+            config.injector = default_injector;
+            if (proc.contains("injector") && !parseInjectorType(proc["injector"], config.injector)) {
+                return false;
+            }
+            // Polling cannot tell injected keys from typed ones, an output
+            // key that is also a trigger would trigger itself
+            if (config.injector == injector_type::send_input && input_config.source == input_source_type::poll) {
+                std::cerr << "Injector send_input of " << config.id << " cannot be used with the poll input source\n";
+                return false;
+            }
+
+            config.breaker = default_breaker;
+            if (proc.contains("breaker") && !parseBreakerConfig(proc["breaker"], config.breaker)) {
+                return false;
+            }
             
             process_configs.push_back(config);
             std::cout << "Added process config: " << config.id 
                       << " with window_sequence: " << config.window_sequence << "\n";
         }
 
+        // Named window groups, "all" is implicit unless redefined
+        if (json.contains("groups")) {
+            for (const auto& [name, members] : json["groups"].items()) {
+                TargetGroup group;
+                if (!parseTargetGroup(name, members, group)) {
+                    return false;
+                }
+                target_groups.push_back(group);
+            }
+        }
+        if (!findTargetGroup("all")) {
+            target_groups.push_back(TargetGroup{"all", {target_selector{}}});
+        }
+
         // Parse key bindings
         for (const auto& binding : json["key_bindings"]) {
             KeyBinding kb;
             kb.trigger_key = binding["trigger_key"].get<std::string>();
+            kb.trigger_vk = key_name_to_vk(kb.trigger_key);
+            if (kb.trigger_vk == 0) {
+                std::cerr << "Warning: unknown trigger key '" << kb.trigger_key << "'\n";
+            }
+            kb.synchronous = binding.value("synchronous", false);
+            kb.sync_timeout_ms = binding.value("sync_timeout_ms", DEFAULT_SYNC_TIMEOUT_MS);
             
             // Parse sequences
             for (const auto& seq : binding["sequences"]) {
                 KeySequence sequence;
-                sequence.target_process = seq["process"].get<std::string>();
-                sequence.instance = seq["instance"].get<int>();
+                if (seq.contains("group")) {
+                    sequence.group = seq["group"].get<std::string>();
+                    if (const TargetGroup* group = findTargetGroup(sequence.group)) {
+                        sequence.targets = group->members;
+                    } else {
+                        std::cerr << "Warning: key binding " << kb.trigger_key
+                                  << " targets unknown group " << sequence.group << "\n";
+                    }
+                } else {
+                    sequence.target_process = seq["process"].get<std::string>();
+                    sequence.instance = seq.value("instance", -1);
+                    sequence.process_index = findProcessIndex(sequence.target_process);
+                    if (sequence.process_index < 0) {
+                        std::cerr << "Warning: key binding " << kb.trigger_key
+                                  << " targets unknown process " << sequence.target_process << "\n";
+                    } else {
+                        sequence.targets.push_back(target_selector{sequence.process_index, sequence.instance});
+                    }
+                }
                 
                 // Parse actions
                 for (const auto& action : seq["actions"]) {
@@ -96,6 +221,17 @@ bool SettingsManager::loadSettings(const fs::path& filepath) {
                     if (action.contains("delay")) {
                         ka.delay = action["delay"].get<int>();
                     }
+                    ka.hold = action.value("hold", key_hold_ms);
+                    if (!ka.key.empty()) {
+                        ka.vk_code = key_name_to_vk(ka.key);
+                        if (ka.vk_code == 0) {
+                            std::cerr << "Warning: unknown key '" << ka.key
+                                      << "' in binding " << kb.trigger_key << "\n";
+                        } else {
+                            ka.scan_code = vk_to_scan_code(ka.vk_code);
+                            ka.extended = vk_is_extended(ka.vk_code);
+                        }
+                    }
                     sequence.actions.push_back(ka);
                 }
                 
@@ -115,14 +251,266 @@ bool SettingsManager::loadSettings(const fs::path& filepath) {
     }
 }
 
+bool SettingsManager::parseChannelConfig(const nlohmann::json& json, ChannelConfig& config) {
+    if (json.contains("type")) {
+        std::string type_name = json["type"].get<std::string>();
+        if (!parse_channel_type(type_name, config.type)) {
+            std::cerr << "Unknown channel type: " << type_name << "\n";
+            return false;
+        }
+    }
+    if (json.contains("capacity")) {
+        config.capacity = json["capacity"].get<size_t>();
+    }
+    if (json.contains("wait")) {
+        std::string mode_name = json["wait"].get<std::string>();
+        if (!parse_wait_mode(mode_name, config.wait.mode)) {
+            std::cerr << "Unknown wait strategy: " << mode_name << "\n";
+            return false;
+        }
+    }
+    if (json.contains("spin_iterations")) {
+        config.wait.spin_iterations = json["spin_iterations"].get<int>();
+    }
+    if (json.contains("yield_iterations")) {
+        config.wait.yield_iterations = json["yield_iterations"].get<int>();
+    }
+    if (json.contains("overflow")) {
+        std::string policy_name = json["overflow"].get<std::string>();
+        if (!parse_overflow_policy(policy_name, config.overflow.policy)) {
+            std::cerr << "Unknown overflow policy: " << policy_name << "\n";
+            return false;
+        }
+    }
+    if (json.contains("block_timeout_us")) {
+        config.overflow.block_timeout_us = json["block_timeout_us"].get<uint32_t>();
+    }
+    // Only the consumer of a ring may move past queued messages
+    if (config.overflow.policy == overflow_policy::drop_oldest && config.type != channel_type::mutex_queue) {
+        std::cerr << "Overflow policy drop_oldest needs a mutex channel, not "
+                  << channel_type_name(config.type) << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool SettingsManager::parseInputConfig(const nlohmann::json& json, InputConfig& config) {
+    if (json.contains("source")) {
+        std::string source_name = json["source"].get<std::string>();
+        if (!parse_input_source_type(source_name, config.source)) {
+            std::cerr << "Unknown input source: " << source_name << "\n";
+            return false;
+        }
+    }
+    if (json.contains("replay_file")) {
+        config.replay_file = json["replay_file"].get<std::string>();
+    }
+    if (json.contains("paced")) {
+        config.paced = json["paced"].get<bool>();
+    }
+    if (config.source == input_source_type::replay && config.replay_file.empty()) {
+        std::cerr << "Replay input source needs a replay_file\n";
+        return false;
+    }
+    return true;
+}
+
+bool SettingsManager::parseBreakerConfig(const nlohmann::json& json, breaker_config& config) {
+    config.timeout_ms = json.value("timeout_ms", config.timeout_ms);
+    config.failure_threshold = json.value("failure_threshold", config.failure_threshold);
+    config.probe_interval_ms = json.value("probe_interval_ms", config.probe_interval_ms);
+    config.max_probe_interval_ms = json.value("max_probe_interval_ms", config.max_probe_interval_ms);
+    if (json.contains("open_policy")) {
+        std::string policy_name = json["open_policy"].get<std::string>();
+        if (!parse_open_policy(policy_name, config.policy)) {
+            std::cerr << "Unknown breaker open_policy: " << policy_name << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SettingsManager::parseExecutionConfig(const nlohmann::json& json, ExecutionConfig& config) {
+    if (json.contains("mode")) {
+        std::string mode_name = json["mode"].get<std::string>();
+        if (!parse_execution_mode(mode_name, config.mode)) {
+            std::cerr << "Unknown execution mode: " << mode_name << "\n";
+            return false;
+        }
+    }
+    if (json.contains("workers")) {
+        config.workers = json["workers"].get<size_t>();
+    }
+    return true;
+}
+
+bool SettingsManager::parseHealthConfig(const nlohmann::json& json, health_config& config) {
+    config.sweep_interval_ms = json.value("sweep_interval_ms", config.sweep_interval_ms);
+    config.rematch_grace_ms = json.value("rematch_grace_ms", config.rematch_grace_ms);
+    config.relaunch_retry_ms = json.value("relaunch_retry_ms", config.relaunch_retry_ms);
+    if (config.sweep_interval_ms == 0) {
+        std::cerr << "health.sweep_interval_ms must be positive\n";
+        return false;
+    }
+    return true;
+}
+
+bool SettingsManager::parseInjectorType(const nlohmann::json& json, injector_type& type) {
+    std::string type_name = json.get<std::string>();
+    if (!parse_injector_type(type_name, type)) {
+        std::cerr << "Unknown injector: " << type_name << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool SettingsManager::parseTitleMatch(const nlohmann::json& json, ProcessConfig& config) {
+    config.title_pattern = json.value("title", config.id);
+    if (json.contains("match")) {
+        std::string mode_name = json["match"].get<std::string>();
+        if (!parse_title_match_mode(mode_name, config.match)) {
+            std::cerr << "Unknown title match mode for " << config.id << ": " << mode_name << "\n";
+            return false;
+        }
+    }
+    if (config.match == title_match_mode::regex) {
+        try {
+            std::regex check(config.title_pattern);
+        } catch (const std::regex_error& e) {
+            std::cerr << "Invalid title regex for " << config.id << ": " << e.what() << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SettingsManager::parseLaunchStep(const nlohmann::json& json, launch_step& step) {
+    // The step's type is the key naming its argument, e.g. {"wait_window": "Launcher"}
+    int types = 0;
+    for (launch_step_type type : {launch_step_type::wait_window, launch_step_type::wait_title,
+                                  launch_step_type::send_keys}) {
+        if (json.contains(launch_step_type_name(type))) {
+            step.type = type;
+            types++;
+        }
+    }
+    if (types != 1) {
+        std::cerr << "A launch step needs exactly one of wait_window, wait_title or send_keys\n";
+        return false;
+    }
+
+    const nlohmann::json& argument = json[launch_step_type_name(step.type)];
+    if (step.type == launch_step_type::send_keys) {
+        std::vector<std::string> names = argument.is_array() ? argument.get<std::vector<std::string>>()
+                                                             : std::vector<std::string>{argument.get<std::string>()};
+        for (const auto& name : names) {
+            uint16_t vk = key_name_to_vk(name);
+            if (vk == 0) {
+                std::cerr << "Unknown key in launch step: " << name << "\n";
+                return false;
+            }
+            step.keys.push_back(vk);
+        }
+        step.delay_ms = json.value("delay_ms", step.delay_ms);
+        step.hold_ms = json.value("hold_ms", step.hold_ms);
+        return true;
+    }
+
+    step.pattern = argument.get<std::string>();
+    step.timeout_ms = json.value("timeout_ms", step.timeout_ms);
+    if (json.contains("match")) {
+        std::string mode_name = json["match"].get<std::string>();
+        if (!parse_title_match_mode(mode_name, step.match)) {
+            std::cerr << "Unknown title match mode in launch step: " << mode_name << "\n";
+            return false;
+        }
+    }
+    if (step.match == title_match_mode::regex) {
+        try {
+            std::regex check(step.pattern);
+        } catch (const std::regex_error& e) {
+            std::cerr << "Invalid title regex in launch step: " << e.what() << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SettingsManager::parseTargetGroup(const std::string& name, const nlohmann::json& json, TargetGroup& group) const {
+    group.name = name;
+    for (const auto& member : json) {
+        std::string spec = member.get<std::string>();
+        std::string process_id = spec;
+        int instance = -1;
+        size_t colon = spec.rfind(':');
+        if (colon != std::string::npos) {
+            process_id = spec.substr(0, colon);
+            try {
+                instance = std::stoi(spec.substr(colon + 1));
+            } catch (const std::exception&) {
+                std::cerr << "Invalid instance in group " << name << ": " << spec << "\n";
+                return false;
+            }
+        }
+        int process_index = findProcessIndex(process_id);
+        if (process_index < 0) {
+            std::cerr << "Warning: group " << name << " contains unknown process " << process_id << "\n";
+            continue;
+        }
+        group.members.push_back(target_selector{process_index, instance});
+    }
+    return true;
+}
+
+const TargetGroup* SettingsManager::findTargetGroup(const std::string& name) const {
+    for (const auto& group : target_groups) {
+        if (group.name == name) {
+            return &group;
+        }
+    }
+    return nullptr;
+}
+
+const ProcessConfig* SettingsManager::findProcessConfig(const std::string& id) const {
+    int index = findProcessIndex(id);
+    return index >= 0 ? &process_configs[index] : nullptr;
+}
+
+int SettingsManager::findProcessIndex(const std::string& id) const {
+    for (size_t i = 0; i < process_configs.size(); ++i) {
+        if (process_configs[i].id == id) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
 
 void SettingsManager::printSettings() const {
     std::cout << "\n=== Current Settings ===\n";
+    std::cout << "Log level: " << log_level_name(log_level_setting) << "\n";
+    std::cout << "Input source: " << input_source_type_name(input_config.source) << "\n";
+    std::cout << "Execution: " << execution_mode_name(execution_config.mode);
+    if (execution_config.mode == execution_mode::pool) {
+        std::cout << " (" << (execution_config.workers ? std::to_string(execution_config.workers) : "auto")
+                  << " workers)";
+    }
+    std::cout << "\n";
+    std::cout << "Health monitor: sweep every " << health.sweep_interval_ms << "ms, relaunch after "
+              << health.rematch_grace_ms << "ms without a window\n";
     std::cout << "Processes (" << process_configs.size() << "):\n";
     for (const auto& proc : process_configs) {
         std::cout << "  - ID: " << proc.id
                   << "\n    Path: " << proc.executable_path
                   << "\n    Instances: " << proc.instances
+                  << "\n    Title: " << title_match_mode_name(proc.match) << " \"" << proc.title_pattern << "\""
+                  << "\n    Launch: " << proc.launch_steps.size() << " steps"
+                  << "\n    Channel: " << channel_type_name(proc.channel.type)
+                  << " (capacity " << proc.channel.capacity
+                  << ", wait " << wait_mode_name(proc.channel.wait.mode)
+                  << ", overflow " << overflow_policy_name(proc.channel.overflow.policy) << ")"
+                  << "\n    Injector: " << injector_type_name(proc.injector)
+                  << " (timeout " << proc.breaker.timeout_ms << "ms, "
+                  << open_policy_name(proc.breaker.policy) << " when unhealthy)"
                   << "\n    Args: ";
         for (const auto& arg : proc.args) {
             std::cout << arg << " ";
@@ -130,12 +518,32 @@ void SettingsManager::printSettings() const {
         std::cout << "\n";
     }
 
+    std::cout << "Groups (" << target_groups.size() << "):\n";
+    for (const auto& group : target_groups) {
+        std::cout << "  - " << group.name << ":";
+        for (const auto& member : group.members) {
+            std::cout << " " << (member.process_index >= 0 ? process_configs[member.process_index].id : "*");
+            if (member.instance >= 0) {
+                std::cout << ":" << member.instance;
+            }
+        }
+        std::cout << "\n";
+    }
+
     std::cout << "\nKey Bindings (" << key_bindings.size() << "):\n";
     for (const auto& kb : key_bindings) {
-        std::cout << "  - Trigger Key: " << kb.trigger_key << "\n";
+        std::cout << "  - Trigger Key: " << kb.trigger_key;
+        if (kb.synchronous) {
+            std::cout << " (synchronous, " << kb.sync_timeout_ms << "ms timeout)";
+        }
+        std::cout << "\n";
         for (const auto& seq : kb.sequences) {
-            std::cout << "    Process: " << seq.target_process
-                      << " (Instance " << seq.instance << ")\n";
+            if (!seq.group.empty()) {
+                std::cout << "    Group: " << seq.group << "\n";
+            } else {
+                std::cout << "    Process: " << seq.target_process << " (Instance "
+                          << (seq.instance >= 0 ? std::to_string(seq.instance) : "all") << ")\n";
+            }
             std::cout << "    Actions:\n";
             for (const auto& action : seq.actions) {
                 std::cout << "      Key: " << action.key;
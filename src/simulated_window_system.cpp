@@ -0,0 +1,236 @@
+#include "simulated_window_system.h"
+#include "timing.h"
+#include <algorithm>
+
+namespace {
+constexpr uint16_t VK_ENTER = 0x0D;
+}
+
+bool simulated_window_system::start() {
+    queue.open();
+    return true;
+}
+
+void simulated_window_system::stop() {
+    queue.close();
+}
+
+bool simulated_window_system::next_event(window_event& event, uint64_t deadline_ns) {
+    for (;;) {
+        uint64_t wake_ns;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            catch_up();
+            wake_ns = std::min(deadline_ns, next_due());
+        }
+        if (queue.pop(event, wake_ns)) {
+            return true;
+        }
+        if (wake_ns == deadline_ns || now_ns() < wake_ns) {
+            return false;  // Deadline passed or stopped
+        }
+    }
+}
+
+std::vector<window_handle> simulated_window_system::list_handles() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    catch_up();
+    return z_order;
+}
+
+bool simulated_window_system::describe(window_handle window, window_info& info) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    catch_up();
+    auto it = windows.find(window);
+    if (it == windows.end()) {
+        return false;
+    }
+    described++;
+    info = window_info{window, it->second.pid, it->second.title, "simulated"};
+    return true;
+}
+
+std::string simulated_window_system::window_title(window_handle window) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    catch_up();
+    auto it = windows.find(window);
+    return it != windows.end() ? it->second.title : std::string();
+}
+
+bool simulated_window_system::is_window(window_handle window) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    catch_up();
+    return windows.count(window) > 0;
+}
+
+bool simulated_window_system::launch(const std::string& path, const std::vector<std::string>&,
+                                     launched_process& process) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto program = programs.find(path);
+    if (program == programs.end() || (program->second.titles.empty() && program->second.spawns.empty())) {
+        return false;
+    }
+    uint32_t pid = start_process(program->second, 0);
+    process.pid = pid;
+    process.handle = reinterpret_cast<void*>(static_cast<uintptr_t>(pid));
+    return true;
+}
+
+uint32_t simulated_window_system::parent_pid(uint32_t pid) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    catch_up();
+    auto it = processes.find(pid);
+    return it != processes.end() ? it->second.parent : 0;
+}
+
+void simulated_window_system::terminate(launched_process& process) {
+    std::lock_guard<std::mutex> lock(mutex);
+    kill(process.pid);
+    process.handle = nullptr;
+}
+
+bool simulated_window_system::post_key(window_handle window, uint16_t vk_code, bool down) {
+    std::lock_guard<std::mutex> lock(mutex);
+    catch_up();
+    auto it = windows.find(window);
+    if (it == windows.end()) {
+        return false;
+    }
+    posted++;
+    const sim_window& target = it->second;
+    auto process = processes.find(target.pid);
+    if (down || vk_code != VK_ENTER || process == processes.end() || !process->second.alive) {
+        return true;
+    }
+    // Enter moves a launcher window on to the next one
+    const simulated_program& program = *process->second.program;
+    if (target.step + 1 < program.titles.size()) {
+        pending.push_back(pending_window{now_ns() + program.step_ns, target.pid, target.step + 1});
+        remove_window(window);
+    }
+    return true;
+}
+
+void simulated_window_system::add_program(const std::string& path, const simulated_program& program) {
+    std::lock_guard<std::mutex> lock(mutex);
+    programs[path] = program;
+}
+
+window_handle simulated_window_system::create_window(uint32_t pid, const std::string& title) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return add_window(pid, title, SIZE_MAX);
+}
+
+void simulated_window_system::destroy_window(window_handle window) {
+    std::lock_guard<std::mutex> lock(mutex);
+    remove_window(window);
+}
+
+void simulated_window_system::set_title(window_handle window, const std::string& title) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = windows.find(window);
+    if (it != windows.end() && it->second.title != title) {
+        it->second.title = title;
+        notify(window_event_type::retitled, window, it->second.pid);
+    }
+}
+
+void simulated_window_system::crash(uint32_t pid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    kill(pid);
+}
+
+size_t simulated_window_system::keys_posted() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return posted;
+}
+
+size_t simulated_window_system::describe_calls() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return described;
+}
+
+void simulated_window_system::catch_up() const {
+    uint64_t now = now_ns();
+    auto due = std::stable_partition(pending.begin(), pending.end(), [now](const pending_window& p) {
+        return p.due_ns <= now;
+    });
+    std::vector<pending_window> ready(pending.begin(), due);
+    pending.erase(pending.begin(), due);
+    std::sort(ready.begin(), ready.end(), [](const pending_window& a, const pending_window& b) {
+        return a.due_ns < b.due_ns;
+    });
+    for (const auto& p : ready) {
+        auto process = processes.find(p.pid);
+        if (process == processes.end() || !process->second.alive) {
+            continue;
+        }
+        if (p.step != SPAWN) {
+            add_window(p.pid, process->second.program->titles[p.step], p.step);
+            continue;
+        }
+        process->second.alive = false;
+        auto child = programs.find(process->second.program->spawns);
+        if (child != programs.end()) {
+            start_process(child->second, p.pid);
+        }
+    }
+}
+
+uint32_t simulated_window_system::start_process(const simulated_program& program, uint32_t parent) const {
+    uint32_t pid = next_pid++;
+    processes[pid] = sim_process{&program, true, parent};
+    size_t first = program.spawns.empty() ? 0 : SPAWN;
+    pending.push_back(pending_window{now_ns() + program.startup_ns, pid, first});
+    return pid;
+}
+
+window_handle simulated_window_system::add_window(uint32_t pid, const std::string& title, size_t step) const {
+    window_handle handle = reinterpret_cast<window_handle>(next_window++);
+    windows[handle] = sim_window{pid, title, step};
+    z_order.insert(z_order.begin(), handle);
+    notify(window_event_type::created, handle, pid);
+    return handle;
+}
+
+void simulated_window_system::remove_window(window_handle window) const {
+    auto it = windows.find(window);
+    if (it == windows.end()) {
+        return;
+    }
+    uint32_t pid = it->second.pid;
+    windows.erase(it);
+    z_order.erase(std::find(z_order.begin(), z_order.end(), window));
+    notify(window_event_type::destroyed, window, pid);
+}
+
+void simulated_window_system::kill(uint32_t pid) {
+    auto it = processes.find(pid);
+    if (it != processes.end()) {
+        it->second.alive = false;
+    }
+    pending.erase(std::remove_if(pending.begin(), pending.end(), [pid](const pending_window& p) {
+        return p.pid == pid;
+    }), pending.end());
+    std::vector<window_handle> owned;
+    for (const auto& [handle, window] : windows) {
+        if (window.pid == pid) {
+            owned.push_back(handle);
+        }
+    }
+    for (window_handle handle : owned) {
+        remove_window(handle);
+    }
+}
+
+void simulated_window_system::notify(window_event_type type, window_handle window, uint32_t pid) const {
+    queue.push(window_event{type, window, pid});
+}
+
+uint64_t simulated_window_system::next_due() const {
+    uint64_t due = NO_DEADLINE;
+    for (const auto& p : pending) {
+        due = std::min(due, p.due_ns);
+    }
+    return due;
+}
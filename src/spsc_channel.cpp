@@ -0,0 +1,105 @@
+#include "spsc_channel.h"
+
+spsc_channel::spsc_channel(size_t capacity, const wait_config& wait)
+    : mask(round_up_pow2(capacity) - 1)
+    , slots(new message[mask + 1])
+    , waiter(wait) {}
+
+bool spsc_channel::try_push(const message& msg) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t - cached_head > mask) {
+        cached_head = head.load(std::memory_order_acquire);
+        if (t - cached_head > mask) {
+            return false;
+        }
+    }
+    slots[t & mask] = msg;
+    tail.store(t + 1, std::memory_order_release);
+    waiter.notify();
+    return true;
+}
+
+bool spsc_channel::try_push_batch(const std::vector<message>& messages) {
+    if (messages.empty()) {
+        return true;
+    }
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t needed = messages.size();
+    if (t + needed - cached_head > mask + 1) {
+        cached_head = head.load(std::memory_order_acquire);
+        if (t + needed - cached_head > mask + 1) {
+            return false;
+        }
+    }
+    for (const auto& msg : messages) {
+        slots[t++ & mask] = msg;
+    }
+    tail.store(t, std::memory_order_release);
+    waiter.notify();
+    return true;
+}
+
+bool spsc_channel::coalesce_newest(const message& msg) {
+    // Only the producer writes slots, so the newest one cannot change under
+    // us. It still counts as queued only if the consumer has not taken it
+    // by the time head is checked, after the comparison.
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t == 0) {
+        return false;
+    }
+    message newest = slots[(t - 1) & mask];
+    if (!coalescible(newest, msg)) {
+        return false;
+    }
+    return head.load(std::memory_order_acquire) < t;
+}
+
+bool spsc_channel::try_pop(message& msg) {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h == cached_tail) {
+        cached_tail = tail.load(std::memory_order_acquire);
+        if (h == cached_tail) {
+            return false;
+        }
+    }
+    msg = std::move(slots[h & mask]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+size_t spsc_channel::try_pop_batch(std::vector<message>& out, size_t max_messages) {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (cached_tail - h < max_messages) {
+        cached_tail = tail.load(std::memory_order_acquire);
+    }
+    size_t count = std::min(max_messages, cached_tail - h);
+    for (size_t i = 0; i < count; ++i) {
+        out.push_back(std::move(slots[(h + i) & mask]));
+    }
+    if (count > 0) {
+        head.store(h + count, std::memory_order_release);
+    }
+    return count;
+}
+
+void spsc_channel::wait_for_messages(const std::atomic<bool>& running) {
+    waiter.wait([this]() {
+        return tail.load(std::memory_order_acquire) != head.load(std::memory_order_relaxed);
+    }, running);
+}
+
+bool spsc_channel::wait_for_messages_until(const std::atomic<bool>& running, uint64_t deadline_ns) {
+    return waiter.wait_until([this]() {
+        return tail.load(std::memory_order_acquire) != head.load(std::memory_order_relaxed);
+    }, running, deadline_ns);
+}
+
+void spsc_channel::wake_all() {
+    waiter.notify_all();
+}
+
+size_t spsc_channel::size() const {
+    size_t h = head.load(std::memory_order_acquire);
+    size_t t = tail.load(std::memory_order_acquire);
+    return t - h;
+}
@@ -0,0 +1,255 @@
+#include "strand_pool.h"
+#include "logger.h"
+#include <algorithm>
+#include <iostream>
+
+void strand::wake() {
+    owner.schedule(this);
+}
+
+strand_pool::strand_pool(size_t worker_count) {
+    if (worker_count == 0) {
+        worker_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < worker_count; ++i) {
+        queues.push_back(std::make_unique<run_queue>());
+    }
+}
+
+strand_pool::~strand_pool() {
+    stop();
+}
+
+void strand_pool::start() {
+    if (running.exchange(true)) {
+        return;
+    }
+    for (size_t i = 0; i < queues.size(); ++i) {
+        workers.emplace_back(&strand_pool::run_worker, this, i);
+    }
+    LOG_INFO("Strand pool started with {} workers", queues.size());
+}
+
+void strand_pool::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    wake_idle_workers(true);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+strand* strand_pool::add_strand(strand::body_type body) {
+    std::lock_guard<std::mutex> lock(strands_mutex);
+    strands.push_back(std::make_unique<strand>(*this, std::move(body)));
+    return strands.back().get();
+}
+
+void strand_pool::retire(strand* s) {
+    // Pairs with the fence in run_strand(): either the worker sees retired
+    // or we see it running and wait for the body to return
+    s->retired.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (s->state.load() >= strand::running) {
+        std::this_thread::yield();
+    }
+}
+
+void strand_pool::schedule(strand* s) {
+    // Pairs with the fence in run_strand(): a body that missed the
+    // producer's publish is seen as running here and runs again
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int state = s->state.load(std::memory_order_relaxed);
+    while (true) {
+        if (state == strand::idle) {
+            if (s->state.compare_exchange_weak(state, strand::queued)) {
+                enqueue(s, next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size());
+                return;
+            }
+        } else if (state == strand::running) {
+            if (s->state.compare_exchange_weak(state, strand::running_woken)) {
+                return;
+            }
+        } else {
+            return;  // Already going to run
+        }
+    }
+}
+
+void strand_pool::enqueue(strand* s, size_t queue_index) {
+    run_queue& queue = *queues[queue_index];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.strands.push_back(s);
+    }
+    queued.fetch_add(1);
+    // Pairs with idle(): either the worker sees queued or we see it sleeping
+    if (sleeping.load() > 0) {
+        wake_idle_workers(false);
+    }
+}
+
+strand* strand_pool::take_work(size_t worker) {
+    {
+        run_queue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.strands.empty()) {
+            strand* s = own.strands.front();
+            own.strands.pop_front();
+            queued.fetch_sub(1);
+            return s;
+        }
+    }
+    for (size_t i = 1; i < queues.size(); ++i) {
+        run_queue& victim = *queues[(worker + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.strands.empty()) {
+            strand* s = victim.strands.back();
+            victim.strands.pop_back();
+            queued.fetch_sub(1);
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return s;
+        }
+    }
+    return nullptr;
+}
+
+void strand_pool::run_strand(strand* s, size_t worker) {
+    s->state.store(strand::running, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (s->retired.load(std::memory_order_relaxed)) {
+        s->state.store(strand::idle);
+        return;
+    }
+
+    uint64_t deadline_ns = s->body();
+    runs.fetch_add(1, std::memory_order_relaxed);
+
+    int state = strand::running;
+    if (!s->state.compare_exchange_strong(state, strand::idle)) {
+        // Woken while running, it goes to the back of this worker's queue
+        s->state.store(strand::queued);
+        enqueue(s, worker);
+    }
+    if (deadline_ns != NO_DEADLINE) {
+        set_deadline(s, deadline_ns);
+    }
+}
+
+void strand_pool::run_worker(size_t worker) {
+    while (running) {
+        fire_due_timers();
+        if (strand* s = take_work(worker)) {
+            run_strand(s, worker);
+        } else {
+            idle();
+        }
+    }
+}
+
+void strand_pool::idle() {
+    // One idle worker waits for the next timer, the others until woken
+    bool keeper = !timer_keeper.exchange(true);
+    uint64_t deadline_ns = NO_DEADLINE;
+    uint64_t wait_until = NO_DEADLINE;
+    bool timed_out = false;
+    {
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        sleeping.fetch_add(1);
+        // Read under the lock, so an earlier timer set from now on wakes us
+        if (keeper) {
+            deadline_ns = next_timer.load();
+            wait_until = timing.coarse_deadline(deadline_ns);
+        }
+        if (queued.load() == 0 && running && (deadline_ns == NO_DEADLINE || now_ns() < wait_until)) {
+            if (deadline_ns == NO_DEADLINE) {
+                idle_cv.wait(lock);
+            } else {
+                timed_out = idle_cv.wait_until(lock, to_steady_time(wait_until)) == std::cv_status::timeout;
+            }
+        }
+        sleeping.fetch_sub(1);
+    }
+    if (keeper) {
+        if (timed_out) {
+            timing.record_wakeup(wait_until, now_ns());
+        }
+        if (deadline_ns != NO_DEADLINE && queued.load() == 0 && next_timer.load() == deadline_ns) {
+            timing.spin_until(deadline_ns);
+        }
+        timer_keeper.store(false);
+    }
+}
+
+void strand_pool::set_deadline(strand* s, uint64_t deadline_ns) {
+    std::lock_guard<std::mutex> lock(timer_mutex);
+    if (deadline_ns >= s->timer_deadline) {
+        return;  // An earlier timer is armed, the body re-arms when it runs
+    }
+    s->timer_deadline = deadline_ns;
+    timers.schedule(deadline_ns, s);
+    uint64_t previous = next_timer.load(std::memory_order_relaxed);
+    next_timer.store(timers.next_deadline());
+    if (deadline_ns < previous) {
+        wake_idle_workers(true);  // The timer keeper waits for a later deadline
+    }
+}
+
+void strand_pool::fire_due_timers() {
+    uint64_t now = now_ns();
+    if (next_timer.load(std::memory_order_relaxed) > now) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(timer_mutex);
+    timers.advance(now, [this](strand* s, uint64_t deadline_ns) {
+        // A later or earlier timer replaced this one
+        if (s->timer_deadline != deadline_ns) {
+            return;
+        }
+        s->timer_deadline = NO_DEADLINE;
+        timer_wakeups.fetch_add(1, std::memory_order_relaxed);
+        schedule(s);
+    });
+    next_timer.store(timers.next_deadline());
+}
+
+void strand_pool::wake_idle_workers(bool all) {
+    std::lock_guard<std::mutex> lock(idle_mutex);
+    if (all) {
+        idle_cv.notify_all();
+    } else {
+        idle_cv.notify_one();
+    }
+}
+
+void strand_pool::print_metrics() const {
+    std::lock_guard<std::mutex> lock(strands_mutex);
+    std::cout << "Strand Pool Metrics:"
+              << " Workers: " << queues.size()
+              << " Strands: " << strands.size()
+              << " Runs: " << runs.load(std::memory_order_relaxed)
+              << " Steals: " << steals.load(std::memory_order_relaxed)
+              << " Timer Wakeups: " << timer_wakeups.load(std::memory_order_relaxed)
+              << std::endl;
+}
+
+bool parse_execution_mode(const std::string& name, execution_mode& mode) {
+    if (name == "threads") {
+        mode = execution_mode::threads;
+    } else if (name == "pool") {
+        mode = execution_mode::pool;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* execution_mode_name(execution_mode mode) {
+    switch (mode) {
+        case execution_mode::pool: return "pool";
+        case execution_mode::threads:
+        default: return "threads";
+    }
+}
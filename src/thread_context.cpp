@@ -1,4 +1,5 @@
 #include "thread_context.h"
+#include "logger.h"
 #include <iostream>
 #include <chrono>
 
@@ -12,17 +13,13 @@ thread_context::thread_context(std::shared_ptr<message_channel> outbound_channel
     , msg_receiver(inbound_channel, running) {}
 
 void thread_context::process_message(const message& msg) {
-    std::cout << context_name << " processing - Command: " << msg.m_command 
-              << " ID: " << msg.m_msg_id 
-              << " Content: " << msg.m_msg << std::endl;
+    LOG_DEBUG("{} processing - Command: {} ID: {}", context_name, msg.m_command, msg.m_msg_id);
 
     // Increment processed count
     messages_processed++;
 
     // Send a response
-    message response(msg.m_command + 1,
-                    msg.m_msg_id,
-                    "Response from " + context_name + " to: " + msg.m_msg);
+    message response(message_command::text, msg.m_msg_id + 1);
     
     if (msg_sender.send_message(response)) {
         messages_sent++;
@@ -32,7 +29,7 @@ void thread_context::process_message(const message& msg) {
 void thread_context::operator()() {
     // Initial message to start the conversation
     if (context_name == "Context1") {
-        message initial_msg(1, 0, "Initial message from " + context_name);
+        message initial_msg(message_command::text, 0);
         if (msg_sender.send_message(initial_msg)) {
             messages_sent++;
         }
@@ -42,14 +39,10 @@ void thread_context::operator()() {
         // Check for incoming messages
         auto received = msg_receiver.receive_batch(10);
         
+        // receive_batch waits on the channel, an empty batch means shutdown
         for (const auto& msg : received) {
             process_message(msg);
         }
-
-        if (received.empty()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            // print_metrics(); // Print metrics periodically when idle
-        }
     }
 }
 
@@ -67,8 +60,8 @@ void thread_context::print_metrics() const {
     std::cout << context_name << " Metrics:"
               << " Messages Processed: " << messages_processed
               << " Messages Sent: " << messages_sent
-              << " Inbound Queue: " << inbound_channel->messages.size()
-              << " Outbound Queue: " << outbound_channel->messages.size()
+              << " Inbound Queue: " << inbound_channel->size()
+              << " Outbound Queue: " << outbound_channel->size()
               << std::endl;
 }
 
@@ -2,15 +2,16 @@
 #include "key_monitor_context.h"
 #include "input_sender_context.h"
 #include "process_manager.h"
+#include "settings_manager.h"
 #include <iostream>
 #include <sstream>
 
-std::unordered_map<std::string, std::shared_ptr<message_channel>> thread_manager::input_channels;
+input_router thread_manager::router;
 
 thread_manager::thread_manager() {
     // Create the key monitor context with its channels
-    auto monitor_outbound = std::make_shared<message_channel>();
-    auto monitor_inbound = std::make_shared<message_channel>();
+    auto monitor_outbound = make_message_channel();
+    auto monitor_inbound = make_message_channel();
     
     key_monitor_outbound = monitor_outbound;  // Store for input senders to use
     
@@ -25,11 +26,19 @@ thread_manager::thread_manager() {
     key_monitor_context = std::move(monitor);
 
     // Clear any existing channels
-    input_channels.clear();
+    router.clear();
+
+    const ExecutionConfig& execution = SettingsManager::getInstance().getExecutionConfig();
+    if (execution.mode == execution_mode::pool) {
+        sender_pool = std::make_unique<strand_pool>(execution.workers);
+    }
 }
 
 thread_manager::~thread_manager() {
-    stop_threads();
+    // Already stopped when the owner stopped the threads itself
+    if (running) {
+        stop_threads();
+    }
 }
 
 void thread_manager::start_threads() {
@@ -40,6 +49,10 @@ void thread_manager::start_threads() {
         key_monitor_context->start();
     }
     
+    if (sender_pool) {
+        sender_pool->start();
+    }
+
     // Start all input contexts
     for (auto& [id, context_info] : input_contexts) {
         if (context_info.context) {
@@ -52,6 +65,9 @@ void thread_manager::stop_threads() {
     std::cout << "Stopping threads..." << std::endl;
     running = false;
     
+    // Wake receivers parked on their inbound channels
+    router.wake_all();
+    
     // Stop key monitor
     if (key_monitor_context) {
         key_monitor_context->stop();
@@ -63,6 +79,10 @@ void thread_manager::stop_threads() {
             context_info.context->stop();
         }
     }
+
+    if (sender_pool) {
+        sender_pool->stop();
+    }
     
     // Print final metrics
     print_metrics();
@@ -86,11 +106,38 @@ bool thread_manager::add_input_sender_context(const std::string& process_id, int
     
     std::cout << "Adding input sender context for " << context_id << std::endl;
     
-    // Create dedicated inbound channel for this input sender
-    auto inbound_channel = std::make_shared<message_channel>();
-    input_channels[context_id] = inbound_channel;  // Store for key monitor to use
+    // Create dedicated inbound channel for this input sender. The key monitor
+    // is its only producer, so the lock-free SPSC ring may be selected here.
+    ChannelConfig channel_config = SettingsManager::getInstance().getChannelConfig();
+    if (const auto* process_config = SettingsManager::getInstance().findProcessConfig(process_id)) {
+        channel_config = process_config->channel;
+    }
+    std::shared_ptr<message_channel> inbound_channel;
+    if (channel_config.type == channel_type::broadcast_ring) {
+        if (!broadcast_bus) {
+            broadcast_bus = std::make_shared<broadcast_ring>(channel_config.capacity, channel_config.wait);
+            broadcast_bus->set_overflow(channel_config.overflow);
+        }
+        int reader = broadcast_bus->add_reader();
+        if (reader < 0) {
+            std::cerr << "Broadcast ring is full, cannot add reader for " << context_id << std::endl;
+            return false;
+        }
+        inbound_channel = std::make_shared<broadcast_channel>(broadcast_bus, reader);
+    } else {
+        inbound_channel = make_message_channel(channel_config.type, channel_config.capacity,
+                                               channel_config.wait);
+        inbound_channel->set_overflow(channel_config.overflow);
+    }
+    // Store for key monitor to use
+    int target_id = router.add_target(SettingsManager::getInstance().findProcessIndex(process_id),
+                                      instance, inbound_channel);
+    if (target_id < 0) {
+        std::cerr << "Too many input senders, cannot route to " << context_id << std::endl;
+        return false;
+    }
     
-    auto outbound = std::make_shared<message_channel>();
+    auto outbound = make_message_channel();
     
     auto input_context = std::make_unique<input_sender_context>(
         outbound,
@@ -101,10 +148,12 @@ bool thread_manager::add_input_sender_context(const std::string& process_id, int
         instance
     );
     input_context->set_name("InputSender_" + context_id);
+    input_context->set_strand_pool(sender_pool.get());
     
     ContextInfo info{
         outbound,
-        std::move(input_context)
+        std::move(input_context),
+        target_id
     };
     
     input_contexts[context_id] = std::move(info);
@@ -127,19 +176,40 @@ bool thread_manager::remove_input_sender_context(const std::string& process_id,
         it->second.context->stop();
     }
     
-    // Remove from both maps
+    // Remove from both the map and the router
+    router.remove_target(it->second.target_id);
     input_contexts.erase(it);
-    input_channels.erase(context_id);
     
     return true;
 }
 
+bool thread_manager::retarget_input_sender_context(const std::string& process_id, int instance, HWND window) {
+    std::ostringstream oss;
+    oss << process_id << ":" << instance;
+    std::string context_id = oss.str();
+
+    // Contexts are only added and removed while the threads are stopped
+    auto it = input_contexts.find(context_id);
+    auto* sender = it != input_contexts.end() ? dynamic_cast<input_sender_context*>(it->second.context.get())
+                                              : nullptr;
+    if (!sender) {
+        std::cerr << "Context not found for " << context_id << std::endl;
+        return false;
+    }
+    sender->retarget(window);
+    return true;
+}
+
 void thread_manager::print_metrics() const {
     std::cout << "\n=== System Metrics ===" << std::endl;
     
     if (key_monitor_context) {
         key_monitor_context->print_metrics();
     }
+
+    if (sender_pool) {
+        sender_pool->print_metrics();
+    }
     
     for (const auto& [id, context_info] : input_contexts) {
         if (context_info.context) {
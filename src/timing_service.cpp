@@ -0,0 +1,107 @@
+#include "timing_service.h"
+#include "platform_hints.h"
+#include "timing.h"
+#include <algorithm>
+#include <thread>
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace {
+constexpr int CALIBRATION_ROUNDS = 16;
+constexpr uint64_t CALIBRATION_SLEEP_NS = 1'000'000;
+
+#ifdef _WIN32
+// Waitable timers cannot be shared between waiting threads
+struct thread_timer {
+    thread_timer() {
+        handle = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                        TIMER_ALL_ACCESS);
+    }
+    ~thread_timer() {
+        if (handle) {
+            CloseHandle(handle);
+        }
+    }
+    HANDLE handle;
+};
+#endif
+}
+
+timing_service::timing_service() {
+#ifdef _WIN32
+    // Also tightens every other timed wait in the process, condition
+    // variables included
+    timeBeginPeriod(1);
+#endif
+    calibrate();
+}
+
+timing_service::~timing_service() {
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+void timing_service::calibrate() {
+    uint64_t worst = 0;
+    for (int i = 0; i < CALIBRATION_ROUNDS; ++i) {
+        uint64_t deadline = now_ns() + CALIBRATION_SLEEP_NS;
+        os_sleep_until(deadline);
+        uint64_t woke = now_ns();
+        worst = std::max(worst, woke > deadline ? woke - deadline : 0);
+    }
+    margin_ns = std::clamp(worst + GUARD_NS, MIN_MARGIN_NS, MAX_MARGIN_NS);
+}
+
+void timing_service::sleep_until(uint64_t deadline_ns) {
+    uint64_t coarse = coarse_deadline(deadline_ns);
+    if (now_ns() < coarse) {
+        os_sleep_until(coarse);
+        record_wakeup(coarse, now_ns());
+    }
+    spin_until(deadline_ns);
+}
+
+void timing_service::spin_until(uint64_t deadline_ns) {
+    while (now_ns() < deadline_ns) {
+        cpu_relax();
+    }
+}
+
+uint64_t timing_service::coarse_deadline(uint64_t deadline_ns) const {
+    if (deadline_ns == NO_DEADLINE) {
+        return NO_DEADLINE;
+    }
+    uint64_t margin = spin_margin_ns();
+    return deadline_ns > margin ? deadline_ns - margin : 0;
+}
+
+void timing_service::record_wakeup(uint64_t requested_ns, uint64_t woke_ns) {
+    uint64_t late = woke_ns > requested_ns ? woke_ns - requested_ns : 0;
+    uint64_t margin = margin_ns.load(std::memory_order_relaxed);
+    uint64_t target = late + GUARD_NS;
+    margin = target > margin ? target : margin - margin / 64;
+    margin_ns.store(std::clamp(margin, MIN_MARGIN_NS, MAX_MARGIN_NS), std::memory_order_relaxed);
+}
+
+void timing_service::os_sleep_until(uint64_t deadline_ns) {
+    uint64_t now = now_ns();
+    if (now >= deadline_ns) {
+        return;
+    }
+#ifdef _WIN32
+    thread_local thread_timer timer;
+    if (timer.handle) {
+        LARGE_INTEGER due;
+        due.QuadPart = -static_cast<long long>((deadline_ns - now) / 100);  // Relative, 100 ns units
+        if (SetWaitableTimer(timer.handle, &due, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(timer.handle, INFINITE);
+            return;
+        }
+    }
+    Sleep(static_cast<DWORD>((deadline_ns - now) / 1'000'000));
+#else
+    std::this_thread::sleep_until(to_steady_time(deadline_ns));
+#endif
+}
@@ -0,0 +1,150 @@
+#include "title_matcher.h"
+#include <algorithm>
+#include <deque>
+
+void title_matcher::add(const std::string& text, title_match_mode mode, int id) {
+    patterns.push_back(pattern{text, mode, id, std::regex()});
+}
+
+bool title_matcher::compile() {
+    nodes.clear();
+    regex_patterns.clear();
+    std::fill(std::begin(alphabet), std::end(alphabet), 0);
+    alphabet_size = 1;
+
+    // Only bytes that occur in some pattern get a symbol of their own
+    for (const auto& p : patterns) {
+        if (p.mode == title_match_mode::regex) {
+            continue;
+        }
+        for (unsigned char c : p.text) {
+            if (!alphabet[c]) {
+                alphabet[c] = static_cast<uint16_t>(alphabet_size++);
+            }
+        }
+    }
+
+    add_node();
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        pattern& p = patterns[i];
+        if (p.mode == title_match_mode::regex) {
+            try {
+                p.compiled = std::regex(p.text, std::regex::ECMAScript | std::regex::optimize);
+            } catch (const std::regex_error&) {
+                return false;
+            }
+            regex_patterns.push_back(static_cast<int>(i));
+            continue;
+        }
+        int state = 0;
+        for (unsigned char c : p.text) {
+            int symbol = alphabet[c];
+            if (nodes[state].next[symbol] < 0) {
+                nodes[state].next[symbol] = add_node();
+            }
+            state = nodes[state].next[symbol];
+        }
+        nodes[state].ends.push_back(static_cast<int>(i));
+    }
+
+    // Breadth-first, turning the trie into a complete automaton
+    std::deque<int> queue;
+    for (int& child : nodes[0].next) {
+        if (child < 0) {
+            child = 0;
+        } else {
+            nodes[child].fail = 0;
+            queue.push_back(child);
+        }
+    }
+    while (!queue.empty()) {
+        int state = queue.front();
+        queue.pop_front();
+        int fail = nodes[state].fail;
+        nodes[state].output_link = nodes[fail].ends.empty() ? nodes[fail].output_link : fail;
+        for (int symbol = 0; symbol < alphabet_size; ++symbol) {
+            int child = nodes[state].next[symbol];
+            if (child < 0) {
+                nodes[state].next[symbol] = nodes[fail].next[symbol];
+            } else {
+                nodes[child].fail = state == 0 ? 0 : nodes[fail].next[symbol];
+                queue.push_back(child);
+            }
+        }
+    }
+    return true;
+}
+
+int title_matcher::add_node() {
+    nodes.emplace_back();
+    nodes.back().next.assign(alphabet_size, -1);
+    return static_cast<int>(nodes.size() - 1);
+}
+
+int title_matcher::match(const std::string& title) const {
+    int best = -1;
+    size_t best_length = 0;
+    if (!nodes.empty()) {
+        // Empty patterns end at the root, which the output links never reach
+        for (int index : nodes[0].ends) {
+            consider(index, 0, 0, title.size(), best, best_length);
+        }
+        int state = 0;
+        for (size_t i = 0; i < title.size(); ++i) {
+            state = nodes[state].next[alphabet[static_cast<unsigned char>(title[i])]];
+            for (int out = nodes[state].ends.empty() ? nodes[state].output_link : state;
+                 out > 0; out = nodes[out].output_link) {
+                for (int index : nodes[out].ends) {
+                    size_t length = patterns[index].text.size();
+                    consider(index, i + 1 - length, length, title.size(), best, best_length);
+                }
+            }
+        }
+    }
+    for (int index : regex_patterns) {
+        std::smatch found;
+        if (std::regex_search(title, found, patterns[index].compiled)) {
+            consider(index, static_cast<size_t>(found.position(0)), static_cast<size_t>(found.length(0)),
+                     title.size(), best, best_length);
+        }
+    }
+    return best >= 0 ? patterns[best].id : -1;
+}
+
+void title_matcher::consider(int index, size_t start, size_t length, size_t title_length,
+                             int& best, size_t& best_length) const {
+    const pattern& p = patterns[index];
+    if ((p.mode == title_match_mode::exact && (start != 0 || length != title_length)) ||
+        (p.mode == title_match_mode::prefix && start != 0)) {
+        return;
+    }
+    if (best < 0 || length > best_length || (length == best_length && index < best)) {
+        best = index;
+        best_length = length;
+    }
+}
+
+bool parse_title_match_mode(const std::string& name, title_match_mode& mode) {
+    if (name == "contains") {
+        mode = title_match_mode::contains;
+    } else if (name == "exact") {
+        mode = title_match_mode::exact;
+    } else if (name == "prefix") {
+        mode = title_match_mode::prefix;
+    } else if (name == "regex") {
+        mode = title_match_mode::regex;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* title_match_mode_name(title_match_mode mode) {
+    switch (mode) {
+        case title_match_mode::exact: return "exact";
+        case title_match_mode::prefix: return "prefix";
+        case title_match_mode::regex: return "regex";
+        case title_match_mode::contains:
+        default: return "contains";
+    }
+}
@@ -0,0 +1,68 @@
+#include "wait_strategy.h"
+
+wait_strategy::wait_strategy(const wait_config& config)
+    : cfg(config) {}
+
+void wait_strategy::notify() {
+    if (wakeup_listener* listener = wake_listener.load(std::memory_order_acquire)) {
+        listener->wake();
+    }
+    if (!may_park()) {
+        return;  // Consumer never sleeps, it will see the publish on its own
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint32_t waiters = parked.load(std::memory_order_relaxed);
+    if (waiters == 0) {
+        return;
+    }
+    // With several parked consumers the one woken might not be the one
+    // whose readiness changed, so all of them check again
+    std::lock_guard<std::mutex> lock(park_mutex);
+    if (waiters == 1) {
+        park_cv.notify_one();
+    } else {
+        park_cv.notify_all();
+    }
+}
+
+void wait_strategy::notify_all() {
+    // Strand consumers never park, the listener is their only wakeup
+    if (wakeup_listener* listener = wake_listener.load(std::memory_order_acquire)) {
+        listener->wake();
+    }
+    std::lock_guard<std::mutex> lock(park_mutex);
+    park_cv.notify_all();
+}
+
+wait_stats wait_strategy::stats() const {
+    wait_stats result;
+    result.spin_wakeups = spin_wakeups.load(std::memory_order_relaxed);
+    result.yield_wakeups = yield_wakeups.load(std::memory_order_relaxed);
+    result.parks = parks.load(std::memory_order_relaxed);
+    return result;
+}
+
+bool parse_wait_mode(const std::string& name, wait_mode& mode) {
+    if (name == "busy_spin") {
+        mode = wait_mode::busy_spin;
+    } else if (name == "spin_yield") {
+        mode = wait_mode::spin_yield;
+    } else if (name == "adaptive") {
+        mode = wait_mode::adaptive;
+    } else if (name == "blocking") {
+        mode = wait_mode::blocking;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* wait_mode_name(wait_mode mode) {
+    switch (mode) {
+        case wait_mode::busy_spin: return "busy_spin";
+        case wait_mode::spin_yield: return "spin_yield";
+        case wait_mode::blocking: return "blocking";
+        case wait_mode::adaptive:
+        default: return "adaptive";
+    }
+}
@@ -0,0 +1,115 @@
+#include "win32_input_injector.h"
+#include "logger.h"
+#include "key_codes.h"
+
+LPARAM make_key_lparam(uint16_t scan_code, bool extended, bool down) {
+    return static_cast<LPARAM>(key_lparam(scan_code, extended, down));
+}
+
+bool window_responds(HWND window, uint32_t timeout_ms) {
+    constexpr uint32_t DEFAULT_PROBE_TIMEOUT_MS = 100;
+    DWORD_PTR result = 0;
+    return SendMessageTimeout(window, WM_NULL, 0, 0, SMTO_ABORTIFHUNG,
+                              timeout_ms ? timeout_ms : DEFAULT_PROBE_TIMEOUT_MS, &result) != 0;
+}
+
+bool send_message_injector::key_down(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) {
+    return send(window, WM_KEYDOWN, vk_code, make_key_lparam(scan_code, extended, true));
+}
+
+bool send_message_injector::key_up(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) {
+    return send(window, WM_KEYUP, vk_code, make_key_lparam(scan_code, extended, false));
+}
+
+bool send_message_injector::probe(window_handle window) {
+    return window_responds(static_cast<HWND>(window), call_timeout_ms);
+}
+
+bool send_message_injector::send(window_handle window, UINT msg, uint16_t vk_code, LPARAM lparam) {
+    if (call_timeout_ms == 0) {
+        SendMessage(static_cast<HWND>(window), msg, vk_code, lparam);
+        error = inject_error::none;
+        return true;
+    }
+    // Returns at once for a window Windows already considers hung
+    DWORD_PTR result = 0;
+    if (SendMessageTimeout(static_cast<HWND>(window), msg, vk_code, lparam,
+                           SMTO_NORMAL | SMTO_ABORTIFHUNG, call_timeout_ms, &result) == 0) {
+        // The message stays queued and may still be handled later
+        error = inject_error::timeout;
+        return false;
+    }
+    error = inject_error::none;
+    return true;
+}
+
+bool post_message_injector::key_down(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) {
+    if (PostMessage(static_cast<HWND>(window), WM_KEYDOWN, vk_code, make_key_lparam(scan_code, extended, true)) == 0) {
+        error = inject_error::rejected;  // Usually the queue of a hung window is full
+        return false;
+    }
+    error = inject_error::none;
+    return true;
+}
+
+bool post_message_injector::key_up(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) {
+    if (PostMessage(static_cast<HWND>(window), WM_KEYUP, vk_code, make_key_lparam(scan_code, extended, false)) == 0) {
+        error = inject_error::rejected;
+        return false;
+    }
+    error = inject_error::none;
+    return true;
+}
+
+bool post_message_injector::probe(window_handle window) {
+    return window_responds(static_cast<HWND>(window), call_timeout_ms);
+}
+
+bool send_input_injector::key_down(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) {
+    key_transition key{vk_code, scan_code, extended, true};
+    return inject(window, &key, 1) == 1;
+}
+
+bool send_input_injector::key_up(window_handle window, uint16_t vk_code, uint16_t scan_code, bool extended) {
+    key_transition key{vk_code, scan_code, extended, false};
+    return inject(window, &key, 1) == 1;
+}
+
+bool send_input_injector::probe(window_handle window) {
+    return window_responds(static_cast<HWND>(window), call_timeout_ms);
+}
+
+size_t send_input_injector::inject(window_handle window, const key_transition* keys, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    if (!bring_to_foreground(window)) {
+        error = inject_error::rejected;
+        return 0;
+    }
+
+    // One SendInput for the whole run, Windows keeps it uninterrupted
+    inputs.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        INPUT& input = inputs[i];
+        input = {};
+        input.type = INPUT_KEYBOARD;
+        input.ki.wVk = keys[i].vk_code;
+        input.ki.wScan = keys[i].scan_code;
+        input.ki.dwFlags = (keys[i].scan_code != 0 ? KEYEVENTF_SCANCODE : 0)
+                         | (keys[i].extended ? KEYEVENTF_EXTENDEDKEY : 0)
+                         | (keys[i].down ? 0 : KEYEVENTF_KEYUP);
+    }
+    UINT sent = SendInput(static_cast<UINT>(count), inputs.data(), sizeof(INPUT));
+    error = sent < count ? inject_error::rejected : inject_error::none;
+    return sent;
+}
+
+bool send_input_injector::bring_to_foreground(window_handle window) {
+    HWND target = static_cast<HWND>(window);
+    if (GetForegroundWindow() != target && (!SetForegroundWindow(target) || GetForegroundWindow() != target)) {
+        LOG_WARN("SendInput: could not bring window 0x{} to the foreground", window);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,228 @@
+#include "win32_window_system.h"
+#include <TlHelp32.h>
+#include "key_codes.h"
+#include "logger.h"
+#include <filesystem>
+
+std::atomic<win32_window_system*> win32_window_system::active{nullptr};
+
+win32_window_system::~win32_window_system() {
+    stop();
+}
+
+bool win32_window_system::start() {
+    win32_window_system* expected = nullptr;
+    if (!active.compare_exchange_strong(expected, this)) {
+        LOG_ERROR("Window event hooks are already installed");
+        return false;
+    }
+
+    queue.open();
+    std::promise<bool> installed;
+    auto result = installed.get_future();
+    hook_thread = std::thread(&win32_window_system::run, this, std::move(installed));
+    if (!result.get()) {
+        hook_thread.join();
+        queue.close();
+        active = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void win32_window_system::stop() {
+    queue.close();
+    if (hook_thread.joinable()) {
+        PostThreadMessageW(hook_thread_id, WM_QUIT, 0, 0);
+        hook_thread.join();
+    }
+    win32_window_system* self = this;
+    active.compare_exchange_strong(self, nullptr);
+}
+
+void win32_window_system::run(std::promise<bool> installed) {
+    // Make sure the thread has a message queue before stop() can post to it
+    MSG msg;
+    PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    hook_thread_id = GetCurrentThreadId();
+
+    // Windows are usually created hidden, so a window counts as created
+    // once it is shown
+    DWORD flags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+    HWINEVENTHOOK lifetime = SetWinEventHook(EVENT_OBJECT_DESTROY, EVENT_OBJECT_SHOW, nullptr,
+                                             &win32_window_system::event_proc, 0, 0, flags);
+    HWINEVENTHOOK names = SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE, nullptr,
+                                          &win32_window_system::event_proc, 0, 0, flags);
+    if (!lifetime || !names) {
+        LOG_ERROR("SetWinEventHook failed, error {}", GetLastError());
+        if (lifetime) {
+            UnhookWinEvent(lifetime);
+        }
+        if (names) {
+            UnhookWinEvent(names);
+        }
+        installed.set_value(false);
+        return;
+    }
+    installed.set_value(true);
+    LOG_INFO("Window event hooks installed");
+
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+        TranslateMessage(&msg);
+        DispatchMessageW(&msg);
+    }
+    UnhookWinEvent(lifetime);
+    UnhookWinEvent(names);
+}
+
+void CALLBACK win32_window_system::event_proc(HWINEVENTHOOK, DWORD event, HWND hwnd, LONG object_id,
+                                              LONG child_id, DWORD, DWORD) {
+    if (!hwnd || object_id != OBJID_WINDOW || child_id != CHILDID_SELF) {
+        return;
+    }
+    win32_window_system* self = active.load(std::memory_order_acquire);
+    if (!self) {
+        return;
+    }
+    window_event change;
+    change.window = hwnd;
+    DWORD pid = 0;
+    GetWindowThreadProcessId(hwnd, &pid);
+    change.pid = pid;
+    switch (event) {
+        case EVENT_OBJECT_SHOW:
+            change.type = window_event_type::created;
+            break;
+        case EVENT_OBJECT_NAMECHANGE:
+            change.type = window_event_type::retitled;
+            break;
+        case EVENT_OBJECT_DESTROY:
+            change.type = window_event_type::destroyed;
+            break;
+        default:
+            return;
+    }
+    // Child controls report the same events, only top-level windows matter.
+    // A destroyed window can no longer be asked for its parent.
+    if (change.type != window_event_type::destroyed && GetAncestor(hwnd, GA_ROOT) != hwnd) {
+        return;
+    }
+    self->queue.push(change);
+}
+
+std::vector<window_handle> win32_window_system::list_handles() const {
+    std::vector<window_handle> handles;
+    EnumWindows(&win32_window_system::enum_proc, reinterpret_cast<LPARAM>(&handles));
+    return handles;
+}
+
+BOOL CALLBACK win32_window_system::enum_proc(HWND handle, LPARAM param) {
+    if (IsWindowVisible(handle)) {
+        reinterpret_cast<std::vector<window_handle>*>(param)->push_back(handle);
+    }
+    return TRUE;
+}
+
+bool win32_window_system::describe(window_handle window, window_info& info) const {
+    HWND hwnd = static_cast<HWND>(window);
+    if (!IsWindow(hwnd)) {
+        return false;
+    }
+    char title[256] = "";
+    char class_name[256] = "";
+    GetWindowTextA(hwnd, title, sizeof(title));
+    GetClassNameA(hwnd, class_name, sizeof(class_name));
+    DWORD pid = 0;
+    GetWindowThreadProcessId(hwnd, &pid);
+    info = window_info{window, static_cast<uint32_t>(pid), title, class_name};
+    return true;
+}
+
+std::string win32_window_system::window_title(window_handle window) const {
+    char title[256] = "";
+    GetWindowTextA(static_cast<HWND>(window), title, sizeof(title));
+    return title;
+}
+
+bool win32_window_system::is_window(window_handle window) const {
+    return IsWindow(static_cast<HWND>(window)) != FALSE;
+}
+
+bool win32_window_system::launch(const std::string& path, const std::vector<std::string>& args,
+                                 launched_process& process) {
+    STARTUPINFOW si = {};
+    si.cb = sizeof(STARTUPINFOW);
+    si.dwFlags = STARTF_USESHOWWINDOW;
+    si.wShowWindow = SW_SHOW;
+
+    PROCESS_INFORMATION pi = {};
+
+    std::filesystem::path exe_path(path);
+    std::wstring wide_path = exe_path.wstring();
+    std::wstring working_dir = exe_path.parent_path().wstring();
+
+    std::string cmd_line = "\"" + path + "\"";
+    for (const auto& arg : args) {
+        cmd_line += " \"" + arg + "\"";
+    }
+    std::wstring wide_cmd_line(cmd_line.begin(), cmd_line.end());
+
+    if (!CreateProcessW(
+            wide_path.c_str(),
+            &wide_cmd_line[0],
+            nullptr,
+            nullptr,
+            FALSE,
+            CREATE_DEFAULT_ERROR_MODE,
+            nullptr,
+            working_dir.c_str(),
+            &si,
+            &pi)) {
+        LOG_ERROR("Failed to create process {}, error {}", path, GetLastError());
+        return false;
+    }
+
+    CloseHandle(pi.hThread);
+    process.handle = pi.hProcess;
+    process.pid = pi.dwProcessId;
+    return true;
+}
+
+void win32_window_system::terminate(launched_process& process) {
+    if (process.handle) {
+        TerminateProcess(static_cast<HANDLE>(process.handle), 0);
+        CloseHandle(static_cast<HANDLE>(process.handle));
+        process.handle = nullptr;
+    }
+}
+
+void win32_window_system::release(launched_process& process) {
+    if (process.handle) {
+        CloseHandle(static_cast<HANDLE>(process.handle));
+        process.handle = nullptr;
+    }
+}
+
+uint32_t win32_window_system::parent_pid(uint32_t pid) const {
+    // A snapshot of every process, callers look up each pid once
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    PROCESSENTRY32W entry = {};
+    entry.dwSize = sizeof(entry);
+    uint32_t parent = 0;
+    for (BOOL more = Process32FirstW(snapshot, &entry); more; more = Process32NextW(snapshot, &entry)) {
+        if (entry.th32ProcessID == pid) {
+            parent = entry.th32ParentProcessID;
+            break;
+        }
+    }
+    CloseHandle(snapshot);
+    return parent;
+}
+
+bool win32_window_system::post_key(window_handle window, uint16_t vk_code, bool down) {
+    LPARAM lparam = static_cast<LPARAM>(key_lparam(vk_to_scan_code(vk_code), vk_is_extended(vk_code), down));
+    return PostMessage(static_cast<HWND>(window), down ? WM_KEYDOWN : WM_KEYUP, vk_code, lparam) != FALSE;
+}
@@ -0,0 +1,45 @@
+#include "window_event_queue.h"
+#include "timing.h"
+
+void window_event_queue::push(const window_event& event) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!accepting) {
+            return;
+        }
+        events.push_back(event);
+    }
+    cv.notify_one();
+}
+
+bool window_event_queue::pop(window_event& event, uint64_t deadline_ns) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (accepting && events.empty()) {
+        if (deadline_ns == NO_DEADLINE) {
+            cv.wait(lock);
+        } else if (now_ns() >= deadline_ns ||
+                   cv.wait_until(lock, to_steady_time(deadline_ns)) == std::cv_status::timeout) {
+            return false;
+        }
+    }
+    if (!accepting) {
+        return false;
+    }
+    event = events.front();
+    events.pop_front();
+    return true;
+}
+
+void window_event_queue::open() {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.clear();
+    accepting = true;
+}
+
+void window_event_queue::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        accepting = false;
+    }
+    cv.notify_all();
+}
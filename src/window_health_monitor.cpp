@@ -0,0 +1,260 @@
+#include "window_health_monitor.h"
+#include "logger.h"
+#include "timing.h"
+#include <iostream>
+
+void window_health_monitor::add_client(const monitored_client& client) {
+    clients.emplace_back(client, clients.size());
+}
+
+bool window_health_monitor::start() {
+    if (running) {
+        return true;
+    }
+    if (!windows.start()) {
+        LOG_ERROR("Window health monitor cannot watch windows on {}", windows.name());
+        return false;
+    }
+    registry.refresh();
+    pipeline.reset();  // Cancelled by an earlier stop()
+    timers = timer_wheel<timer>(TIMER_TICK_NS);
+    lost_clients = 0;
+    uint64_t now = now_ns();
+    for (auto& c : clients) {
+        c.window = registry.attached(window_key{c.client.spec.id, c.client.spec.instance});
+        c.health = client_health::attached;
+        if (!c.window) {
+            lose(c, "not attached", now);
+        }
+    }
+    timers.schedule(now + uint64_t{cfg.sweep_interval_ms} * 1'000'000, timer{SWEEP, 0});
+    running = true;
+    worker = std::thread(&window_health_monitor::run, this);
+    LOG_INFO("Window health monitor watching {} clients", clients.size());
+    return true;
+}
+
+void window_health_monitor::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    pipeline.cancel();  // A relaunch in progress gives up
+    windows.stop();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void window_health_monitor::run() {
+    while (running) {
+        window_event event;
+        if (windows.next_event(event, timers.next_deadline())) {
+            on_event(event, now_ns());
+        }
+        timers.advance(now_ns(), [this](const timer& fired, uint64_t) {
+            on_timer(fired, now_ns());
+        });
+    }
+}
+
+void window_health_monitor::on_event(const window_event& event, uint64_t now) {
+    registry_diff diff;
+    registry.apply(event, diff);
+    client_state* c = client_of(event.window);
+    switch (event.type) {
+        case window_event_type::destroyed:
+            if (c) {
+                lose(*c, "window destroyed", now);
+            }
+            break;
+        case window_event_type::retitled:
+            if (c) {
+                const window_info* info = registry.find(event.window);
+                if (!info || matcher.match(info->title) != c->client.match_id) {
+                    registry.detach(window_key{c->client.spec.id, c->client.spec.instance});
+                    lose(*c, "window retitled", now);
+                }
+                break;
+            }
+            offer(event.window);
+            break;
+        case window_event_type::created:
+            offer(event.window);
+            break;
+    }
+}
+
+void window_health_monitor::on_timer(const timer& fired, uint64_t now) {
+    if (fired.client == SWEEP) {
+        sweep(now);
+        timers.schedule(now + uint64_t{cfg.sweep_interval_ms} * 1'000'000, timer{SWEEP, 0});
+        return;
+    }
+    client_state& c = clients[fired.client];
+    if (fired.generation != c.generation || c.health != client_health::lost) {
+        return;
+    }
+    if (c.client.relaunch) {
+        relaunch_due(now);
+    } else {
+        LOG_WARN("{} instance {} still has no window", c.client.spec.id, c.client.spec.instance);
+    }
+}
+
+void window_health_monitor::sweep(uint64_t now) {
+    // Catches whatever the events missed, including events consumed while
+    // a relaunch was running or the window system was stopped. Titles of
+    // other windows are fetched only when new or reported retitled.
+    for (auto& c : clients) {
+        if (c.health == client_health::attached) {
+            registry.mark_dirty(c.window);
+        }
+    }
+    registry.refresh();
+    for (auto& c : clients) {
+        if (c.health != client_health::attached) {
+            continue;
+        }
+        const window_info* info = registry.find(c.window);
+        if (!info || registry.attached(window_key{c.client.spec.id, c.client.spec.instance}) != c.window) {
+            lose(c, "window gone", now);
+        } else if (matcher.match(info->title) != c.client.match_id) {
+            registry.detach(window_key{c.client.spec.id, c.client.spec.instance});
+            lose(c, "window retitled", now);
+        }
+    }
+    if (lost_clients > 0) {
+        offer_all();
+    }
+}
+
+void window_health_monitor::lose(client_state& c, const char* reason, uint64_t now) {
+    if (c.health != client_health::attached) {
+        return;
+    }
+    LOG_WARN("{} instance {} lost window 0x{}: {}", c.client.spec.id, c.client.spec.instance,
+             c.window, reason);
+    c.window = nullptr;
+    c.health = client_health::lost;
+    c.generation++;
+    lost_clients++;
+    loss_count.fetch_add(1, std::memory_order_relaxed);
+    c.relaunch_ns = now + uint64_t{cfg.rematch_grace_ms} * 1'000'000;
+    timers.schedule(c.relaunch_ns, timer{c.index, c.generation});
+    // A relogged client may already have its new window up
+    registry.refresh();
+    offer_all();
+}
+
+void window_health_monitor::offer(window_handle window) {
+    if (lost_clients == 0 || registry.owner(window)) {
+        return;
+    }
+    const window_info* info = registry.find(window);
+    if (!info || info->title.empty()) {
+        return;  // Offered again when it gets its title
+    }
+    int id = matcher.match(info->title);
+    if (id < 0) {
+        return;
+    }
+    // Lowest instance first, like the initial scan
+    for (auto& c : clients) {
+        if (c.health == client_health::lost && c.client.match_id == id) {
+            reattach(c, window, launched_process{});
+            return;
+        }
+    }
+}
+
+void window_health_monitor::offer_all() {
+    std::vector<window_handle> order = registry.z_order();
+    for (window_handle window : order) {
+        if (lost_clients == 0) {
+            return;
+        }
+        offer(window);
+    }
+}
+
+void window_health_monitor::reattach(client_state& c, window_handle window, const launched_process& process) {
+    registry.attach(window_key{c.client.spec.id, c.client.spec.instance}, window);
+    c.window = window;
+    c.health = client_health::attached;
+    c.generation++;
+    lost_clients--;
+    reattach_count.fetch_add(1, std::memory_order_relaxed);
+    const window_info* info = registry.find(window);
+    LOG_INFO("{} instance {} re-attached to window 0x{}: {}", c.client.spec.id, c.client.spec.instance,
+             window, info ? info->title : std::string());
+    if (on_reattach) {
+        on_reattach(c.client, window, process);
+    }
+}
+
+void window_health_monitor::relaunch_due(uint64_t now) {
+    // Clients lost together, e.g. to a disconnect, come back together
+    std::vector<client_state*> due;
+    std::vector<launch_spec> specs;
+    for (auto& c : clients) {
+        if (c.health == client_health::lost && c.client.relaunch && c.relaunch_ns <= now) {
+            LOG_INFO("Relaunching {} instance {}", c.client.spec.id, c.client.spec.instance);
+            c.health = client_health::relaunching;
+            due.push_back(&c);
+            specs.push_back(c.client.spec);
+        }
+    }
+    relaunch_count.fetch_add(due.size(), std::memory_order_relaxed);
+    // Blocks the monitor until they are up, the sweep afterwards picks up
+    // whatever happened to the other clients meanwhile
+    std::vector<launch_result> results = pipeline.run(specs);
+    uint64_t retry_ns = now_ns() + uint64_t{cfg.relaunch_retry_ms} * 1'000'000;
+    for (size_t i = 0; i < due.size(); ++i) {
+        client_state& c = *due[i];
+        launch_result& result = results[i];
+        c.health = client_health::lost;
+        if (result.state == launch_state::ready && running) {
+            reattach(c, result.window, result.process);
+            continue;
+        }
+        if (result.state == launch_state::ready) {
+            windows.terminate(result.process);
+        }
+        c.generation++;
+        c.relaunch_ns = retry_ns;
+        timers.schedule(retry_ns, timer{c.index, c.generation});
+    }
+}
+
+window_health_monitor::client_state* window_health_monitor::client_of(window_handle window) {
+    for (auto& c : clients) {
+        if (c.health == client_health::attached && c.window == window) {
+            return &c;
+        }
+    }
+    return nullptr;
+}
+
+void window_health_monitor::print_metrics() const {
+    std::cout << "Window health:"
+              << " Losses: " << losses()
+              << " Re-attached: " << reattaches()
+              << " Relaunches: " << relaunches()
+              << std::endl;
+    for (const auto& c : clients) {
+        client_health health = c.health.load(std::memory_order_relaxed);
+        if (health != client_health::attached) {
+            std::cout << "  " << c.client.spec.id << ":" << c.client.spec.instance
+                      << " " << client_health_name(health) << std::endl;
+        }
+    }
+}
+
+const char* client_health_name(client_health health) {
+    switch (health) {
+        case client_health::lost: return "lost";
+        case client_health::relaunching: return "relaunching";
+        case client_health::attached:
+        default: return "attached";
+    }
+}
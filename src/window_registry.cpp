@@ -0,0 +1,155 @@
+#include "window_registry.h"
+
+registry_diff window_registry::refresh() {
+    registry_diff diff;
+    diff.generation = ++current_generation;
+    order = windows.list_handles();
+    for (window_handle handle : order) {
+        auto it = by_handle.find(handle);
+        if (it == by_handle.end()) {
+            entry e;
+            e.info.handle = handle;
+            if (!fetch(e)) {
+                continue;  // Gone between the enumeration and the fetch
+            }
+            e.seen = current_generation;
+            by_handle.emplace(handle, std::move(e));
+            diff.added.push_back(handle);
+            continue;
+        }
+        entry& e = it->second;
+        e.seen = current_generation;
+        if (e.dirty) {
+            std::string old_title = e.info.title;
+            if (fetch(e) && e.info.title != old_title) {
+                diff.retitled.push_back(handle);
+            }
+        }
+    }
+
+    for (auto it = by_handle.begin(); it != by_handle.end();) {
+        if (it->second.seen != current_generation) {
+            diff.removed.push_back(it->first);
+            window_handle handle = it->first;
+            ++it;
+            forget(handle);
+        } else {
+            ++it;
+        }
+    }
+    return diff;
+}
+
+bool window_registry::apply(const window_event& event, registry_diff& diff) {
+    diff = registry_diff{};
+    diff.generation = current_generation;
+    auto it = by_handle.find(event.window);
+    switch (event.type) {
+        case window_event_type::created: {
+            if (it != by_handle.end()) {
+                return false;
+            }
+            entry e;
+            e.info.handle = event.window;
+            if (!fetch(e)) {
+                return false;
+            }
+            e.seen = current_generation;
+            by_handle.emplace(event.window, std::move(e));
+            diff.added.push_back(event.window);
+            return true;
+        }
+        case window_event_type::retitled: {
+            if (it == by_handle.end()) {
+                return false;
+            }
+            std::string old_title = it->second.info.title;
+            it->second.dirty = true;
+            if (!fetch(it->second) || it->second.info.title == old_title) {
+                return false;
+            }
+            diff.retitled.push_back(event.window);
+            return true;
+        }
+        case window_event_type::destroyed:
+            if (it == by_handle.end()) {
+                return false;
+            }
+            forget(event.window);
+            diff.removed.push_back(event.window);
+            return true;
+    }
+    return false;
+}
+
+const window_info* window_registry::find(window_handle window) const {
+    auto it = by_handle.find(window);
+    return it != by_handle.end() ? &it->second.info : nullptr;
+}
+
+void window_registry::mark_dirty(window_handle window) {
+    auto it = by_handle.find(window);
+    if (it != by_handle.end()) {
+        it->second.dirty = true;
+    }
+}
+
+void window_registry::attach(const window_key& key, window_handle window) {
+    detach(key);
+    auto existing = by_handle.find(window);
+    if (existing != by_handle.end() && existing->second.key) {
+        detach(*existing->second.key);
+    }
+    auto slot = by_key.emplace(key, window).first;
+    auto it = by_handle.find(window);
+    if (it == by_handle.end()) {
+        // Attached before any refresh saw it, e.g. straight after a launch
+        entry e;
+        e.info.handle = window;
+        fetch(e);
+        e.seen = current_generation;
+        it = by_handle.emplace(window, std::move(e)).first;
+    }
+    it->second.key = &slot->first;
+}
+
+void window_registry::detach(const window_key& key) {
+    auto it = by_key.find(key);
+    if (it == by_key.end()) {
+        return;
+    }
+    auto window = by_handle.find(it->second);
+    if (window != by_handle.end()) {
+        window->second.key = nullptr;
+    }
+    by_key.erase(it);
+}
+
+window_handle window_registry::attached(const window_key& key) const {
+    auto it = by_key.find(key);
+    return it != by_key.end() ? it->second : nullptr;
+}
+
+const window_key* window_registry::owner(window_handle window) const {
+    auto it = by_handle.find(window);
+    return it != by_handle.end() ? it->second.key : nullptr;
+}
+
+bool window_registry::fetch(entry& e) {
+    e.dirty = false;
+    return windows.describe(e.info.handle, e.info);
+}
+
+void window_registry::forget(window_handle window) {
+    // A dead window's key is detached too, so attached() tells its owner the
+    // window is gone rather than handing out a handle the system may reuse
+    auto it = by_handle.find(window);
+    if (it == by_handle.end()) {
+        return;
+    }
+    if (it->second.key) {
+        window_key key = *it->second.key;
+        by_key.erase(key);
+    }
+    by_handle.erase(it);
+}
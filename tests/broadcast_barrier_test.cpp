@@ -0,0 +1,127 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "broadcast_barrier.h"
+#include "timing.h"
+#include "test_support.h"
+
+static constexpr uint64_t MS = 1'000'000;
+
+// A sender that missed a moment by more than the stale time must not count
+// towards the moment that took over its slot. Runs first, so both moments
+// get slot 0.
+static void test_stale_slot_reclaimed() {
+    broadcast_barrier& barrier = broadcast_barrier::get_instance();
+    uint16_t stale = 0;
+    CHECK(barrier.open(2, now_ns() - 2000 * MS, stale));
+    uint16_t current = 0;
+    CHECK(barrier.open(2, now_ns() + 20 * MS, current));
+    CHECK((current & (broadcast_barrier::SLOTS - 1)) == (stale & (broadcast_barrier::SLOTS - 1)));
+    CHECK(current != stale);
+
+    barrier.skip(stale);
+    barrier.skip(stale);
+    barrier.finish(stale, now_ns());
+    CHECK(!barrier.arrive_and_wait(stale));
+
+    // Still waiting for its second window
+    uint64_t timeouts = barrier.timeouts();
+    CHECK(!barrier.arrive_and_wait(current));
+    CHECK(barrier.timeouts() == timeouts + 1);
+    barrier.withdraw(current, 1);
+    barrier.finish(current, 0);
+}
+
+// Same while a late sender is still hammering the stale moment
+static void test_reclaim_during_late_updates() {
+    broadcast_barrier& barrier = broadcast_barrier::get_instance();
+    int polluted = 0;
+    for (int round = 0; round < 500; ++round) {
+        uint16_t stale = 0;
+        CHECK(barrier.open(60000, now_ns() - 2000 * MS, stale));
+        std::atomic<bool> late{true};
+        std::atomic<int> skips{0};
+        std::thread sender([&]() {
+            while (late) {
+                barrier.skip(stale);
+                skips++;
+            }
+        });
+        while (skips < 100) {
+            std::this_thread::yield();
+        }
+        uint16_t current = 0;
+        CHECK(barrier.open(2, now_ns() + MS, current));
+        late = false;
+        sender.join();
+
+        uint64_t timeouts = barrier.timeouts();
+        bool waited_out = !barrier.arrive_and_wait(current) && barrier.timeouts() == timeouts + 1;
+        polluted += waited_out ? 0 : 1;
+        barrier.withdraw(current, 1);
+        barrier.finish(current, 0);
+    }
+    CHECK(polluted == 0);
+}
+
+static void test_all_windows_arrive() {
+    broadcast_barrier& barrier = broadcast_barrier::get_instance();
+    constexpr int WINDOWS = 3;
+    uint16_t token = 0;
+    CHECK(barrier.open(WINDOWS, now_ns() + 2000 * MS, token));
+
+    std::atomic<int> passed{0};
+    std::vector<std::thread> senders;
+    for (int i = 0; i < WINDOWS; ++i) {
+        senders.emplace_back([&]() {
+            if (barrier.arrive_and_wait(token)) {
+                passed++;
+            }
+            barrier.finish(token, now_ns());
+        });
+    }
+    for (auto& sender : senders) {
+        sender.join();
+    }
+    CHECK(passed == WINDOWS);
+
+    // Complete, a late arrival finds nothing to wait for
+    CHECK(!barrier.arrive_and_wait(token));
+}
+
+static void test_deadline() {
+    broadcast_barrier& barrier = broadcast_barrier::get_instance();
+    uint16_t token = 0;
+    uint64_t start = now_ns();
+    CHECK(barrier.open(2, start + 10 * MS, token));
+    uint64_t timeouts = barrier.timeouts();
+    CHECK(!barrier.arrive_and_wait(token));
+    CHECK(now_ns() >= start + 10 * MS);
+    CHECK(barrier.timeouts() == timeouts + 1);
+    barrier.finish(token, 0);
+    barrier.withdraw(token, 1);
+    CHECK(!barrier.arrive_and_wait(token));
+}
+
+// Windows that were skipped or never reached do not hold up the others
+static void test_withdraw_and_skip() {
+    broadcast_barrier& barrier = broadcast_barrier::get_instance();
+    uint16_t token = 0;
+    CHECK(barrier.open(4, now_ns() + 10 * MS, token));
+    barrier.withdraw(token, 2);
+    barrier.skip(token);
+    uint64_t timeouts = barrier.timeouts();
+    CHECK(barrier.arrive_and_wait(token));
+    CHECK(barrier.timeouts() == timeouts);
+    barrier.finish(token, now_ns());
+    CHECK(!barrier.arrive_and_wait(token));
+}
+
+int main() {
+    test_stale_slot_reclaimed();
+    test_reclaim_during_late_updates();
+    test_all_windows_arrive();
+    test_deadline();
+    test_withdraw_and_skip();
+    return test_result("broadcast_barrier_test");
+}
@@ -0,0 +1,149 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "broadcast_channel.h"
+#include "test_support.h"
+
+struct counting_listener : wakeup_listener {
+    int wakes{0};
+    void wake() override { wakes++; }
+};
+
+// Readers running as strands only learn about work through their listener
+static void test_wake_all_reaches_listeners() {
+    broadcast_ring ring(8);
+    int addressed = ring.add_reader();
+    int idle = ring.add_reader();
+    counting_listener addressed_listener;
+    counting_listener idle_listener;
+    ring.set_listener(addressed, &addressed_listener);
+    ring.set_listener(idle, &idle_listener);
+
+    ring.publish(message(message_command::key_press, 1), uint64_t{1} << addressed);
+    CHECK(addressed_listener.wakes == 1);
+    CHECK(idle_listener.wakes == 0);
+
+    ring.wake_all();
+    CHECK(addressed_listener.wakes == 2);
+    CHECK(idle_listener.wakes == 1);
+}
+
+// A reader nobody addresses must not fill the ring for the others
+static void test_idle_reader_does_not_hold_ring() {
+    broadcast_ring ring(8);
+    int addressed = ring.add_reader();
+    ring.add_reader();  // Never reads
+
+    int published = 0;
+    int read = 0;
+    message msg;
+    for (uint32_t id = 0; id < 1000; ++id) {
+        published += ring.publish(message(message_command::key_press, id), uint64_t{1} << addressed);
+        while (ring.try_read(addressed, msg)) {
+            CHECK(msg.m_msg_id == static_cast<uint32_t>(read));
+            read++;
+        }
+    }
+    CHECK(published == 1000);
+    CHECK(read == 1000);
+}
+
+// Readers that are moved forward by the writer while they read still see
+// every entry addressed to them, in order
+static void test_concurrent_readers_skipped_ahead() {
+    constexpr uint32_t MESSAGES = 200000;
+    constexpr uint32_t SHARED_EVERY = 97;  // Entries also addressed to the sparse reader
+    broadcast_ring ring(16);
+    int busy = ring.add_reader();
+    int sparse = ring.add_reader();
+
+    std::atomic<bool> done{false};
+    auto read_all = [&](int reader, bool batched, uint32_t& count, bool& ordered) {
+        std::vector<message> batch;
+        int64_t last = -1;
+        auto take = [&](const message& msg) {
+            ordered = ordered && static_cast<int64_t>(msg.m_msg_id) > last;
+            last = msg.m_msg_id;
+            count++;
+        };
+        while (true) {
+            bool finished = done.load();
+            message msg;
+            if (batched) {
+                batch.clear();
+                ring.try_read_batch(reader, batch, 4);
+                for (const auto& m : batch) {
+                    take(m);
+                }
+            } else {
+                while (ring.try_read(reader, msg)) {
+                    take(msg);
+                }
+            }
+            if (finished && ring.pending(reader) == 0) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    };
+
+    uint32_t busy_count = 0;
+    uint32_t sparse_count = 0;
+    bool busy_ordered = true;
+    bool sparse_ordered = true;
+    std::thread busy_reader([&]() { read_all(busy, false, busy_count, busy_ordered); });
+    std::thread sparse_reader([&]() { read_all(sparse, true, sparse_count, sparse_ordered); });
+    uint32_t shared = 0;
+    for (uint32_t id = 0; id < MESSAGES; ++id) {
+        uint64_t targets = uint64_t{1} << busy;
+        if (id % SHARED_EVERY == 0) {
+            targets |= uint64_t{1} << sparse;
+            shared++;
+        }
+        while (!ring.publish(message(message_command::key_press, id), targets)) {
+            std::this_thread::yield();
+        }
+    }
+    done = true;
+    busy_reader.join();
+    sparse_reader.join();
+
+    CHECK(busy_count == MESSAGES);
+    CHECK(sparse_count == shared);
+    CHECK(busy_ordered);
+    CHECK(sparse_ordered);
+}
+
+// A removed reader frees its slot, even with entries it never read
+static void test_removed_reader_released() {
+    auto ring = std::make_shared<broadcast_ring>(8);
+    int kept = ring->add_reader();
+    auto removed = std::make_unique<broadcast_channel>(ring, ring->add_reader());
+    uint64_t both = (uint64_t{1} << kept) | removed->reader_mask();
+    for (uint32_t id = 0; id < 4; ++id) {
+        CHECK(ring->publish(message(message_command::key_press, id), both));
+    }
+    int index = static_cast<int>(lowest_bit(removed->reader_mask()));
+    removed.reset();
+
+    message msg;
+    int read = 0;
+    for (uint32_t id = 4; id < 100; ++id) {
+        CHECK(ring->publish(message(message_command::key_press, id), uint64_t{1} << kept));
+        while (ring->try_read(kept, msg)) {
+            read++;
+        }
+    }
+    CHECK(read == 100);
+    CHECK(ring->add_reader() == index);
+    CHECK(ring->pending(index) == 0);
+}
+
+int main() {
+    test_wake_all_reaches_listeners();
+    test_idle_reader_does_not_hold_ring();
+    test_concurrent_readers_skipped_ahead();
+    test_removed_reader_released();
+    return test_result("broadcast_channel_test");
+}
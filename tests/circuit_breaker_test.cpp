@@ -0,0 +1,183 @@
+#include <chrono>
+#include <deque>
+#include <thread>
+#include "circuit_breaker.h"
+#include "recording_injector.h"
+#include "timing.h"
+#include "test_support.h"
+
+static constexpr uint64_t MS = 1'000'000;
+
+static breaker_config test_config(open_policy policy) {
+    breaker_config config;
+    config.timeout_ms = 5;
+    config.failure_threshold = 2;
+    config.probe_interval_ms = 20;
+    config.max_probe_interval_ms = 50;
+    config.policy = policy;
+    return config;
+}
+
+// One target window driven the way an input sender drives it: keys are
+// injected while the breaker is closed and dropped or parked while it is
+// not, and a due probe decides when the window is healthy again.
+struct sender_window {
+    recording_injector injector;
+    circuit_breaker breaker;
+    window_handle window{reinterpret_cast<window_handle>(0x1)};
+    std::deque<uint16_t> parked;
+    size_t dropped{0};
+
+    explicit sender_window(const breaker_config& config) : breaker(config) {
+        injector.set_timeout(config.timeout_ms);
+    }
+
+    void send(uint16_t vk) {
+        if (!breaker.closed()) {
+            if (breaker.config().policy == open_policy::park) {
+                parked.push_back(vk);
+            } else {
+                dropped++;
+            }
+            return;
+        }
+        inject(vk);
+    }
+
+    bool inject(uint16_t vk) {
+        key_transition keys[] = {{vk, 0, false, true}, {vk, 0, false, false}};
+        if (injector.inject(window, keys, 2) == 2) {
+            breaker.record_success();
+            return true;
+        }
+        breaker.record_failure(now_ns());
+        return false;
+    }
+
+    void probe_if_due() {
+        if (!breaker.probe_due(now_ns())) {
+            return;
+        }
+        breaker.begin_probe();
+        if (!injector.probe(window)) {
+            breaker.record_failure(now_ns());
+            return;
+        }
+        breaker.record_success();
+        while (!parked.empty() && breaker.closed()) {
+            inject(parked.front());
+            parked.pop_front();
+        }
+    }
+
+    size_t key_downs() const {
+        size_t count = 0;
+        for (const auto& key : injector.keys()) {
+            count += key.down ? 1 : 0;
+        }
+        return count;
+    }
+};
+
+static void wait_for_probe(sender_window& target) {
+    uint64_t due = target.breaker.next_probe_ns();
+    while (now_ns() < due) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    target.probe_if_due();
+}
+
+// Only consecutive timeouts trip, a slow but answering window does not
+static void test_trip() {
+    sender_window target(test_config(open_policy::drop));
+    target.injector.set_response_delay(2 * MS);
+    target.send('A');
+    CHECK(target.breaker.closed());
+
+    target.injector.set_response_delay(50 * MS);
+    uint64_t start = now_ns();
+    target.send('B');
+    CHECK(now_ns() - start >= 5 * MS);       // Waited out the timeout
+    CHECK(now_ns() - start < 50 * MS);       // but not the window
+    CHECK(target.injector.last_error() == inject_error::timeout);
+    CHECK(target.breaker.closed());
+
+    target.injector.set_response_delay(0);
+    target.send('C');
+    target.injector.set_response_delay(50 * MS);
+    target.send('D');
+    CHECK(target.breaker.closed());
+    target.send('E');
+    CHECK(target.breaker.current() == breaker_state::open);
+    CHECK(target.breaker.trips() == 1);
+    CHECK(target.key_downs() == 2);
+}
+
+// Failed probes back off up to the cap, a good one closes the breaker
+static void test_probe_backoff_and_recovery() {
+    sender_window target(test_config(open_policy::drop));
+    target.injector.set_response_delay(50 * MS);
+    target.send('A');
+    target.send('A');
+    CHECK(!target.breaker.closed());
+
+    uint64_t tripped = now_ns();
+    CHECK(target.breaker.next_probe_ns() >= tripped);
+    CHECK(target.breaker.next_probe_ns() <= tripped + 20 * MS);
+    target.probe_if_due();
+    CHECK(target.breaker.probes() == 0);  // Not due yet
+
+    uint64_t expected_ns[] = {40 * MS, 50 * MS, 50 * MS};
+    for (uint64_t expected : expected_ns) {
+        wait_for_probe(target);
+        CHECK(target.breaker.current() == breaker_state::open);
+        uint64_t wait_ns = target.breaker.next_probe_ns() - now_ns();
+        CHECK(wait_ns <= expected);
+        CHECK(wait_ns + 10 * MS >= expected);
+    }
+    CHECK(target.breaker.probes() == 3);
+
+    target.injector.set_response_delay(0);
+    wait_for_probe(target);
+    CHECK(target.breaker.closed());
+    CHECK(target.breaker.recoveries() == 1);
+    CHECK(target.breaker.next_probe_ns() == NO_DEADLINE);
+
+    // Back to the first interval after recovery
+    target.injector.set_response_delay(50 * MS);
+    target.send('B');
+    target.send('B');
+    CHECK(target.breaker.next_probe_ns() <= now_ns() + 20 * MS);
+    CHECK(target.breaker.trips() == 2);
+}
+
+static void test_drop_and_park() {
+    sender_window dropping(test_config(open_policy::drop));
+    sender_window parking(test_config(open_policy::park));
+    for (sender_window* target : {&dropping, &parking}) {
+        target->injector.set_response_delay(50 * MS);
+        target->send('A');
+        target->send('A');
+        target->send('B');
+        target->send('C');
+        target->injector.set_response_delay(0);
+        wait_for_probe(*target);
+        CHECK(target->breaker.closed());
+    }
+
+    CHECK(dropping.dropped == 2);
+    CHECK(dropping.key_downs() == 0);
+
+    // Parked keys are delivered after recovery, in order
+    CHECK(parking.dropped == 0);
+    auto keys = parking.injector.keys();
+    CHECK(keys.size() == 4);
+    CHECK(keys.size() == 4 && keys[0].vk_code == 'B' && keys[0].down && keys[2].vk_code == 'C');
+}
+
+int main() {
+    test_trip();
+    test_probe_backoff_and_recovery();
+    test_drop_and_park();
+    return test_result("circuit_breaker_test");
+}
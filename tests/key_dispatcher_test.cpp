@@ -0,0 +1,89 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "key_codes.h"
+#include "key_dispatcher.h"
+#include "mutex_channel.h"
+#include "timing.h"
+#include "test_support.h"
+
+constexpr uint64_t DELAY_NS = 50'000'000;
+
+static KeyAction action(const char* key, int delay) {
+    KeyAction a;
+    a.key = key;
+    a.delay = delay;
+    a.vk_code = key_name_to_vk(key);
+    return a;
+}
+
+// Trigger "1" sends "A" to window 0:0 after a leading 50 ms delay
+static KeyBinding delayed_binding(bool synchronous) {
+    KeySequence sequence;
+    sequence.process_index = 0;
+    sequence.instance = 0;
+    sequence.targets = {target_selector{0, 0}};
+    sequence.actions = {action("", static_cast<int>(DELAY_NS / 1'000'000)), action("A", 0)};
+
+    KeyBinding binding;
+    binding.trigger_key = "1";
+    binding.trigger_vk = key_name_to_vk("1");
+    binding.synchronous = synchronous;
+    binding.sequences = {sequence};
+    return binding;
+}
+
+// Runs the dispatcher's timers until a message arrives or a second passes
+static bool wait_for_key(key_dispatcher& dispatcher, message_channel& channel, message& msg) {
+    uint64_t give_up = now_ns() + 1'000'000'000;
+    while (now_ns() < give_up) {
+        dispatcher.run_due(now_ns());
+        if (channel.try_pop(msg)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void test_leading_delay(bool synchronous) {
+    input_router router;
+    auto channel = std::make_shared<mutex_channel>();
+    router.add_target(0, 0, channel);
+    std::vector<KeyBinding> bindings = {delayed_binding(synchronous)};
+    key_dispatcher dispatcher(router);
+    dispatcher.compile(bindings, {"game"}, 0);
+
+    uint64_t detected = now_ns();
+    dispatcher.on_key_down(key_name_to_vk("1"), detected);
+    CHECK(channel->size() == 0);
+    CHECK(dispatcher.next_deadline() != NO_DEADLINE);
+    CHECK(dispatcher.next_deadline() >= detected + DELAY_NS);
+
+    message msg;
+    CHECK(wait_for_key(dispatcher, *channel, msg));
+    CHECK(msg.vk_code == key_name_to_vk("A"));
+    CHECK(msg.enqueue_ns >= detected + DELAY_NS);
+    CHECK(dispatcher.messages_sent() == 1);
+}
+
+static void test_no_delay_is_inline() {
+    input_router router;
+    auto channel = std::make_shared<mutex_channel>();
+    router.add_target(0, 0, channel);
+    KeyBinding binding = delayed_binding(false);
+    binding.sequences[0].actions.erase(binding.sequences[0].actions.begin());
+    std::vector<KeyBinding> bindings = {binding};
+    key_dispatcher dispatcher(router);
+    dispatcher.compile(bindings, {"game"}, 0);
+
+    dispatcher.on_key_down(key_name_to_vk("1"), now_ns());
+    CHECK(channel->size() == 1);
+    CHECK(dispatcher.next_deadline() == NO_DEADLINE);
+}
+
+int main() {
+    test_leading_delay(false);
+    test_leading_delay(true);
+    test_no_delay_is_inline();
+    return test_result("key_dispatcher_test");
+}
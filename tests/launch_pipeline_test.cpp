@@ -0,0 +1,168 @@
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "launch_pipeline.h"
+#include "simulated_window_system.h"
+#include "window_registry.h"
+#include "test_support.h"
+
+static simulated_program client_program() {
+    simulated_program program;
+    program.titles = {"Launcher", "Login", "Anarchy Online"};
+    program.startup_ns = 10'000'000;
+    program.step_ns = 10'000'000;
+    return program;
+}
+
+static launch_spec client(const std::string& path, int instance, int window_sequence) {
+    launch_spec spec;
+    spec.id = "client";
+    spec.instance = instance;
+    spec.path = path;
+    spec.window_sequence = window_sequence;
+    return spec;
+}
+
+static launch_step wait_for(const std::string& pattern, uint32_t timeout_ms) {
+    launch_step step;
+    step.pattern = pattern;
+    step.timeout_ms = timeout_ms;
+    return step;
+}
+
+// Every client goes through its launcher windows on its own window
+static void test_concurrent_launch() {
+    simulated_window_system windows;
+    windows.add_program("Anarchy.exe", client_program());
+    windows.start();
+    window_registry registry(windows);
+    launch_pipeline pipeline(windows, registry);
+
+    std::vector<launch_spec> specs;
+    for (int i = 0; i < 4; ++i) {
+        specs.push_back(client("Anarchy.exe", i, 3));
+    }
+    std::vector<launch_result> results = pipeline.run(specs);
+
+    CHECK(results.size() == specs.size());
+    std::set<window_handle> distinct;
+    for (const auto& result : results) {
+        CHECK(result.state == launch_state::ready);
+        CHECK(result.title == "Anarchy Online");
+        CHECK(windows.is_window(result.window));
+        distinct.insert(result.window);
+    }
+    CHECK(distinct.size() == specs.size());
+    windows.stop();
+}
+
+// A bootstrapper that starts the client as a child and exits still owns
+// the client's window
+static void test_child_process_window() {
+    simulated_window_system windows;
+    simulated_program bootstrapper;
+    bootstrapper.titles = {};
+    bootstrapper.startup_ns = 5'000'000;
+    bootstrapper.spawns = "Anarchy.exe";
+    windows.add_program("Bootstrap.exe", bootstrapper);
+    windows.add_program("Anarchy.exe", client_program());
+    windows.start();
+    window_registry registry(windows);
+    launch_pipeline pipeline(windows, registry);
+
+    launch_spec spec = client("Bootstrap.exe", 0, 3);
+    spec.steps = default_launch_steps(3);
+    for (auto& step : spec.steps) {
+        step.timeout_ms = 2000;
+    }
+    std::vector<launch_result> results = pipeline.run({spec});
+
+    CHECK(results[0].state == launch_state::ready);
+    CHECK(results[0].title == "Anarchy Online");
+    window_info info;
+    CHECK(windows.describe(results[0].window, info));
+    CHECK(info.pid != results[0].process.pid);
+    CHECK(windows.parent_pid(info.pid) == results[0].process.pid);
+    windows.stop();
+}
+
+// A window no launch can be traced to is claimed by a title pattern, but
+// never one that existed before the launch
+static void test_unattributed_window_by_title() {
+    simulated_window_system windows;
+    simulated_program detached;
+    detached.titles = {};
+    detached.spawns = "Elsewhere.exe";  // Not a known program, the launch leaves no process behind
+    windows.add_program("Detached.exe", detached);
+    windows.start();
+    window_handle stale = windows.create_window(4242, "Anarchy Online");
+    window_registry registry(windows);
+    launch_pipeline pipeline(windows, registry);
+
+    launch_spec spec = client("Detached.exe", 0, 1);
+    spec.steps = {wait_for("Anarchy Online", 2000)};
+    window_handle fresh = nullptr;
+    std::thread desktop([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        fresh = windows.create_window(4343, "Anarchy Online");
+    });
+    std::vector<launch_result> results = pipeline.run({spec});
+    desktop.join();
+
+    CHECK(results[0].state == launch_state::ready);
+    CHECK(results[0].window == fresh);
+    CHECK(results[0].window != stale);
+    windows.stop();
+}
+
+// Without a pattern to go by, windows of unrelated processes are left alone
+static void test_unrelated_window_ignored() {
+    simulated_window_system windows;
+    simulated_program detached;
+    detached.titles = {};
+    detached.spawns = "Elsewhere.exe";
+    windows.add_program("Detached.exe", detached);
+    windows.start();
+    window_registry registry(windows);
+    launch_pipeline pipeline(windows, registry);
+
+    launch_spec spec = client("Detached.exe", 0, 1);
+    spec.steps = {wait_for("", 200)};
+    std::thread desktop([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        windows.create_window(4343, "Notepad");
+    });
+    std::vector<launch_result> results = pipeline.run({spec});
+    desktop.join();
+
+    CHECK(results[0].state == launch_state::failed);
+    CHECK(results[0].window == nullptr);
+    windows.stop();
+}
+
+// Nothing to wait for is a configuration error, not a ready client
+static void test_empty_script_fails() {
+    simulated_window_system windows;
+    windows.add_program("Anarchy.exe", client_program());
+    windows.start();
+    window_registry registry(windows);
+    launch_pipeline pipeline(windows, registry);
+
+    std::vector<launch_result> results = pipeline.run({client("Anarchy.exe", 0, 0)});
+    CHECK(results.size() == 1);
+    CHECK(results[0].state == launch_state::failed);
+    CHECK(results[0].window == nullptr);
+    CHECK(results[0].process.pid == 0);
+    windows.stop();
+}
+
+int main() {
+    test_concurrent_launch();
+    test_child_process_window();
+    test_unattributed_window_by_title();
+    test_unrelated_window_ignored();
+    test_empty_script_fails();
+    return test_result("launch_pipeline_test");
+}
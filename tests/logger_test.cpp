@@ -0,0 +1,63 @@
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "logger.h"
+#include "test_support.h"
+
+// Records of several threads come out in the order they were written, and
+// the buffers of threads that exited are freed once drained
+static void test_merge_and_reclaim() {
+    constexpr int THREADS = 4;
+    constexpr int RECORDS = 200;  // Per thread, fits a buffer so none is dropped
+
+    std::ostringstream output;
+    logger& log = logger::get_instance();
+    log.set_output(output);
+    log.set_level(log_level::info);
+
+    // Written before start(), so one drain has to merge every buffer
+    std::mutex order;
+    int sequence = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < RECORDS; ++i) {
+                std::lock_guard<std::mutex> lock(order);
+                LOG_INFO("record {} from thread {}", sequence++, t);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(log.thread_buffers() == THREADS);
+
+    log.start();
+    log.stop();
+    log.set_output(std::cout);
+
+    std::istringstream lines(output.str());
+    std::string line;
+    int expected = 0;
+    bool ordered = true;
+    while (std::getline(lines, line)) {
+        size_t at = line.find("record ");
+        if (at == std::string::npos) {
+            continue;
+        }
+        ordered = ordered && std::stoi(line.substr(at + 7)) == expected;
+        expected++;
+    }
+    CHECK(expected == THREADS * RECORDS);
+    CHECK(ordered);
+    CHECK(log.dropped_records() == 0);
+    CHECK(log.thread_buffers() == 0);
+}
+
+int main() {
+    test_merge_and_reclaim();
+    return test_result("logger_test");
+}
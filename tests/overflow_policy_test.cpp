@@ -0,0 +1,112 @@
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "message_channel.h"
+#include "timing.h"
+#include "test_support.h"
+
+static message key(uint16_t vk, uint64_t trigger_ns) {
+    return message(message_command::key_press, 0, vk, 0, -1, -1, trigger_ns);
+}
+
+static std::shared_ptr<message_channel> full_channel(channel_type type, overflow_policy policy,
+                                                     uint32_t block_timeout_us = 1000) {
+    auto channel = make_message_channel(type, 4);
+    overflow_config config;
+    config.policy = policy;
+    config.block_timeout_us = block_timeout_us;
+    channel->set_overflow(config);
+    for (uint16_t vk = 'A'; vk < 'E'; ++vk) {
+        channel->push(key(vk, vk));
+    }
+    return channel;
+}
+
+static void test_coalesce(channel_type type) {
+    auto channel = make_message_channel(type, 4);
+    overflow_config config;
+    config.policy = overflow_policy::coalesce;
+    channel->set_overflow(config);
+
+    // A double tap with room to spare reaches the window twice
+    CHECK(channel->push(key('A', 1)));
+    CHECK(channel->push(key('A', 2)));
+    CHECK(channel->size() == 2);
+
+    // Once full, a repeat of the newest key is absorbed by it
+    CHECK(channel->push(key('B', 3)));
+    CHECK(channel->push(key('C', 4)));
+    CHECK(channel->size() == 4);
+    CHECK(channel->push(key('C', 5)));
+    CHECK(channel->get_overflow_stats().coalesced == 1);
+
+    // but never one from the same trigger, and never a different key
+    CHECK(!channel->push(key('C', 4)));
+    CHECK(!channel->push(key('D', 6)));
+    CHECK(channel->get_overflow_stats().dropped == 2);
+    CHECK(channel->size() == 4);
+
+    message msg;
+    CHECK(channel->try_pop(msg) && msg.vk_code == 'A' && msg.timestamp_ns == 1);
+    CHECK(channel->try_pop(msg) && msg.vk_code == 'A' && msg.timestamp_ns == 2);
+}
+
+static void test_drop_oldest() {
+    auto channel = full_channel(channel_type::mutex_queue, overflow_policy::drop_oldest);
+    CHECK(channel->push(key('E', 'E')));
+    CHECK(channel->size() == 4);
+    CHECK(channel->get_overflow_stats().evicted == 1);
+    CHECK(channel->get_overflow_stats().dropped == 0);
+
+    message msg;
+    CHECK(channel->try_pop(msg) && msg.vk_code == 'B');
+}
+
+// A ring producer cannot evict, the new key is dropped instead
+static void test_drop_oldest_degraded(channel_type type) {
+    auto channel = full_channel(type, overflow_policy::drop_oldest);
+    CHECK(!channel->push(key('E', 'E')));
+    CHECK(channel->get_overflow_stats().evicted == 0);
+    CHECK(channel->get_overflow_stats().dropped == 1);
+
+    message msg;
+    CHECK(channel->try_pop(msg) && msg.vk_code == 'A');
+}
+
+static void test_block(channel_type type) {
+    constexpr uint32_t TIMEOUT_US = 5000;
+
+    // Nobody makes room, the key is dropped once the timeout passed
+    auto channel = full_channel(type, overflow_policy::block, TIMEOUT_US);
+    uint64_t start = now_ns();
+    CHECK(!channel->push(key('E', 'E')));
+    CHECK(now_ns() - start >= uint64_t{TIMEOUT_US} * 1000);
+    CHECK(channel->get_overflow_stats().blocked == 1);
+    CHECK(channel->get_overflow_stats().dropped == 1);
+
+    // A consumer making room in time lets the push through
+    channel = full_channel(type, overflow_policy::block, 1'000'000);
+    std::thread consumer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        message msg;
+        channel->try_pop(msg);
+    });
+    CHECK(channel->push(key('E', 'E')));
+    consumer.join();
+    CHECK(channel->get_overflow_stats().blocked == 1);
+    CHECK(channel->get_overflow_stats().dropped == 0);
+    CHECK(channel->size() == 4);
+}
+
+int main() {
+    test_coalesce(channel_type::mutex_queue);
+    test_coalesce(channel_type::spsc_ring);
+    test_coalesce(channel_type::broadcast_ring);
+    test_drop_oldest();
+    test_drop_oldest_degraded(channel_type::spsc_ring);
+    test_drop_oldest_degraded(channel_type::broadcast_ring);
+    test_block(channel_type::mutex_queue);
+    test_block(channel_type::spsc_ring);
+    test_block(channel_type::broadcast_ring);
+    return test_result("overflow_policy_test");
+}
@@ -0,0 +1,108 @@
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "key_codes.h"
+#include "key_dispatcher.h"
+#include "mutex_channel.h"
+#include "replay_input_source.h"
+#include "timing.h"
+#include "test_support.h"
+
+static std::string write_replay(const std::string& name, const std::string& text) {
+    std::string path = name + ".replay";
+    std::ofstream(path) << text;
+    return path;
+}
+
+static void test_load_file() {
+    std::vector<input_event> events;
+    std::string path = write_replay("valid", "# trigger 1 twice\n"
+                                             "0 down 0x31\n"
+                                             "\n"
+                                             "20.5 up 49  # same key in decimal\n");
+    CHECK(replay_input_source::load_file(path, events));
+    CHECK(events.size() == 2);
+    CHECK(events[0].vk_code == 0x31 && events[0].key_down && events[0].timestamp_ns == 0);
+    CHECK(events[1].vk_code == 0x31 && !events[1].key_down && events[1].timestamp_ns == 20'500'000);
+    std::remove(path.c_str());
+
+    for (const char* bad : {"0 press 0x31\n", "0 down 0\n", "0 down 0x100\n", "-5 down 0x31\n"}) {
+        events.clear();
+        path = write_replay("invalid", bad);
+        CHECK(!replay_input_source::load_file(path, events));
+        std::remove(path.c_str());
+    }
+    CHECK(!replay_input_source::load_file("missing.replay", events));
+}
+
+// Paced replay holds every event back until its offset
+static void test_paced() {
+    std::vector<input_event> events(2);
+    events[0] = input_event{0x31, 0, true, false, 30'000'000};
+    events[1] = input_event{0x31, 0, false, false, 0};  // Out of order on purpose
+    replay_input_source source(events, true);
+    CHECK(source.start());
+    uint64_t started = now_ns();
+
+    input_event event;
+    CHECK(source.next_event(event, NO_DEADLINE));
+    CHECK(!event.key_down);
+    CHECK(!source.next_event(event, now_ns() + 1'000'000));  // Not due yet
+    CHECK(source.next_event(event, NO_DEADLINE));
+    CHECK(event.key_down);
+    CHECK(event.timestamp_ns >= started + 30'000'000);
+    CHECK(source.finished());
+    CHECK(!source.next_event(event, now_ns() + 1'000'000));
+    source.stop();
+}
+
+// A replayed trigger drives the dispatcher like a real key press
+static void test_replay_through_dispatcher() {
+    input_router router;
+    auto channel = std::make_shared<mutex_channel>();
+    router.add_target(0, 0, channel);
+
+    KeyAction press;
+    press.key = "A";
+    press.vk_code = key_name_to_vk("A");
+    KeySequence sequence;
+    sequence.targets = {target_selector{0, 0}};
+    sequence.actions = {press};
+    KeyBinding binding;
+    binding.trigger_key = "1";
+    binding.trigger_vk = key_name_to_vk("1");
+    binding.sequences = {sequence};
+    std::vector<KeyBinding> bindings = {binding};
+    key_dispatcher dispatcher(router);
+    dispatcher.compile(bindings, {"game"}, 0);
+
+    // Two taps of 1 and a key nobody bound
+    std::string path = write_replay("taps", "0 down 0x31\n5 up 0x31\n10 down 0x32\n15 down 0x31\n20 up 0x31\n");
+    replay_input_source source(path, false);
+    CHECK(source.start());
+    input_event event;
+    while (source.next_event(event, now_ns())) {
+        if (event.key_down) {
+            dispatcher.on_key_down(event.vk_code, event.timestamp_ns);
+        }
+    }
+    CHECK(source.finished());
+    source.stop();
+    std::remove(path.c_str());
+
+    CHECK(dispatcher.keys_processed() == 2);
+    CHECK(channel->size() == 2);
+    message msg;
+    while (channel->try_pop(msg)) {
+        CHECK(msg.vk_code == key_name_to_vk("A"));
+    }
+}
+
+int main() {
+    test_load_file();
+    test_paced();
+    test_replay_through_dispatcher();
+    return test_result("replay_input_source_test");
+}
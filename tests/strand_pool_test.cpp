@@ -0,0 +1,136 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "strand_pool.h"
+#include "timing.h"
+#include "test_support.h"
+
+template <typename Condition>
+static bool wait_for(Condition condition) {
+    for (int i = 0; i < 2000; ++i) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+// Wakes from many threads never run one body on two workers at once
+static void test_never_concurrent() {
+    strand_pool pool(4);
+    pool.start();
+    std::atomic<int> inside{0};
+    std::atomic<int> overlaps{0};
+    std::atomic<int> runs{0};
+    strand* s = pool.add_strand([&]() {
+        if (inside.fetch_add(1) != 0) {
+            overlaps++;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        inside.fetch_sub(1);
+        runs++;
+        return NO_DEADLINE;
+    });
+
+    std::vector<std::thread> wakers;
+    for (int t = 0; t < 4; ++t) {
+        wakers.emplace_back([s]() {
+            for (int i = 0; i < 500; ++i) {
+                s->wake();
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& waker : wakers) {
+        waker.join();
+    }
+    pool.retire(s);
+    pool.stop();
+    CHECK(overlaps == 0);
+    CHECK(runs > 0);
+}
+
+// A wake that arrives while the body runs is not lost
+static void test_wake_while_running() {
+    strand_pool pool(2);
+    pool.start();
+    std::atomic<int> runs{0};
+    std::atomic<bool> release{false};
+    strand* s = pool.add_strand([&]() {
+        if (runs++ == 0) {
+            while (!release) {
+                std::this_thread::yield();
+            }
+        }
+        return NO_DEADLINE;
+    });
+
+    s->wake();
+    CHECK(wait_for([&]() { return runs == 1; }));
+    s->wake();
+    s->wake();  // Folded into the one pending run
+    release = true;
+    CHECK(wait_for([&]() { return runs == 2; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(runs == 2);
+    pool.stop();
+}
+
+// A returned deadline runs the body again, never before it is due
+static void test_deadline() {
+    constexpr uint64_t DELAY_NS = 20'000'000;
+    strand_pool pool(2);
+    pool.start();
+    std::atomic<int> runs{0};
+    std::atomic<uint64_t> due_ns{0};
+    std::atomic<uint64_t> ran_ns{0};
+    strand* s = pool.add_strand([&]() {
+        if (runs++ == 0) {
+            due_ns = now_ns() + DELAY_NS;
+            return due_ns.load();
+        }
+        ran_ns = now_ns();
+        return NO_DEADLINE;
+    });
+
+    s->wake();
+    CHECK(wait_for([&]() { return runs == 2; }));
+    CHECK(ran_ns >= due_ns);
+    CHECK(ran_ns - due_ns < 200'000'000);
+    pool.stop();
+}
+
+// retire() returns only after a running body did, and the strand stays quiet
+static void test_retire_waits_for_body() {
+    strand_pool pool(2);
+    pool.start();
+    std::atomic<int> runs{0};
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    strand* s = pool.add_strand([&]() {
+        runs++;
+        entered = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        finished = true;
+        return now_ns() + 1'000'000;
+    });
+
+    s->wake();
+    CHECK(wait_for([&]() { return entered.load(); }));
+    pool.retire(s);
+    CHECK(finished);
+    s->wake();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(runs == 1);
+    pool.stop();
+}
+
+int main() {
+    test_never_concurrent();
+    test_wake_while_running();
+    test_deadline();
+    test_retire_waits_for_body();
+    return test_result("strand_pool_test");
+}
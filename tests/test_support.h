@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal checks for the unit tests. Unlike assert they stay on in release
+// builds; a failed check prints its location and the test exits non-zero.
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            test_failures()++;                                                        \
+        }                                                                             \
+    } while (0)
+
+inline int test_result(const char* name) {
+    if (test_failures() == 0) {
+        std::printf("%s: passed\n", name);
+        return EXIT_SUCCESS;
+    }
+    std::printf("%s: %d checks failed\n", name, test_failures());
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <vector>
+#include "timer_wheel.h"
+#include "test_support.h"
+
+static constexpr uint64_t TICK_NS = 1000;
+static constexpr uint64_t START_NS = 1'000'000'000;
+
+struct fired_timer {
+    int item;
+    uint64_t deadline_ns;
+    uint64_t now_ns;
+};
+
+// Advances to now_ns and returns what fired
+static std::vector<fired_timer> advance(timer_wheel<int>& wheel, uint64_t now_ns) {
+    std::vector<fired_timer> fired;
+    wheel.advance(now_ns, [&](int item, uint64_t deadline_ns) {
+        fired.push_back(fired_timer{item, deadline_ns, now_ns});
+    });
+    return fired;
+}
+
+// Timers on every level, and past the top one, cascade down and fire on
+// their tick, not before
+static void test_cascade_across_levels() {
+    timer_wheel<int> wheel(TICK_NS, START_NS);
+    const uint64_t delays[] = {
+        5,                // Level 0
+        64 + 7,           // Level 1
+        64 * 64 * 3 + 9,  // Level 2
+        64 * 64 * 64 * 5 + 11,
+        uint64_t{64} * 64 * 64 * 64 + 13  // Beyond the wheel, parked at the top
+    };
+    int item = 0;
+    for (uint64_t delay : delays) {
+        wheel.schedule(START_NS + delay * TICK_NS, item++);
+    }
+    CHECK(wheel.size() == 5);
+    CHECK(wheel.next_deadline() == START_NS + delays[0] * TICK_NS);
+
+    item = 0;
+    for (uint64_t delay : delays) {
+        uint64_t deadline_ns = START_NS + delay * TICK_NS;
+        CHECK(advance(wheel, deadline_ns - 1).empty());
+        auto fired = advance(wheel, deadline_ns);
+        CHECK(fired.size() == 1);
+        CHECK(!fired.empty() && fired[0].item == item && fired[0].deadline_ns == deadline_ns);
+        item++;
+    }
+    CHECK(wheel.empty());
+    CHECK(wheel.next_deadline() == NO_DEADLINE);
+}
+
+// Deadlines inside a tick round up to its end, a timer never fires early
+static void test_never_early() {
+    timer_wheel<int> wheel(TICK_NS, START_NS);
+    std::vector<uint64_t> deadlines;
+    uint64_t seed = 12345;
+    for (int i = 0; i < 2000; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t deadline_ns = START_NS + (seed >> 33) % (TICK_NS * 64 * 64 * 8);
+        deadlines.push_back(deadline_ns);
+        wheel.schedule(deadline_ns, i);
+    }
+
+    size_t fired_count = 0;
+    uint64_t last_tick = 0;
+    bool early = false;
+    bool ordered = true;
+    for (uint64_t now = START_NS; !wheel.empty(); now += 777) {
+        for (const auto& fired : advance(wheel, now)) {
+            early = early || fired.now_ns < fired.deadline_ns;
+            uint64_t tick = (fired.deadline_ns + TICK_NS - 1) / TICK_NS;
+            ordered = ordered && tick >= last_tick;
+            last_tick = tick;
+            CHECK(fired.deadline_ns == deadlines[fired.item]);
+            fired_count++;
+        }
+        CHECK(wheel.empty() || wheel.next_deadline() + TICK_NS > now);
+    }
+    CHECK(fired_count == deadlines.size());
+    CHECK(!early);
+    CHECK(ordered);
+}
+
+// Timers due on the same tick fire in the order they were scheduled, and a
+// callback may schedule one that is already due
+static void test_order_within_slot() {
+    timer_wheel<int> wheel(TICK_NS, START_NS);
+    uint64_t deadline_ns = START_NS + 200 * TICK_NS;
+    for (int i = 0; i < 10; ++i) {
+        wheel.schedule(deadline_ns, i);
+    }
+    std::vector<int> order;
+    wheel.advance(deadline_ns, [&](int item, uint64_t) {
+        order.push_back(item);
+        if (item == 3) {
+            wheel.schedule(deadline_ns - TICK_NS, 100);
+        }
+    });
+    CHECK(order.size() == 11);
+    for (int i = 0; i < 10 && i < static_cast<int>(order.size()); ++i) {
+        CHECK(order[i] == i);
+    }
+    CHECK(order.size() == 11 && order[10] == 100);
+    CHECK(wheel.empty());
+}
+
+int main() {
+    test_cascade_across_levels();
+    test_never_early();
+    test_order_within_slot();
+    return test_result("timer_wheel_test");
+}
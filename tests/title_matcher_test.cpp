@@ -0,0 +1,123 @@
+#include <string>
+#include "title_matcher.h"
+#include "test_support.h"
+
+// Overlapping patterns are only found through the fail and output links
+static void test_overlapping_patterns() {
+    title_matcher matcher;
+    matcher.add("he", title_match_mode::contains, 1);
+    matcher.add("she", title_match_mode::contains, 2);
+    matcher.add("his", title_match_mode::contains, 3);
+    matcher.add("hers", title_match_mode::contains, 4);
+    CHECK(matcher.compile());
+
+    CHECK(matcher.match("ushers") == 4);
+    CHECK(matcher.match("ushe") == 2);
+    CHECK(matcher.match("this") == 3);
+    CHECK(matcher.match("xhex") == 1);
+    CHECK(matcher.match("sh") == -1);
+    CHECK(matcher.match("") == -1);
+
+    // A pattern inside a longer one that failed to complete
+    title_matcher nested;
+    nested.add("abcd", title_match_mode::contains, 1);
+    nested.add("bc", title_match_mode::contains, 2);
+    nested.add("c", title_match_mode::contains, 3);
+    CHECK(nested.compile());
+    CHECK(nested.match("xabcx") == 2);
+    CHECK(nested.match("xacx") == 3);
+    CHECK(nested.match("abcd") == 1);
+}
+
+static void test_exact_and_prefix() {
+    title_matcher matcher;
+    matcher.add("Anarchy Online", title_match_mode::exact, 1);
+    matcher.add("Anarchy", title_match_mode::contains, 2);
+    matcher.add("AO - ", title_match_mode::prefix, 3);
+    CHECK(matcher.compile());
+
+    CHECK(matcher.match("Anarchy Online") == 1);
+    CHECK(matcher.match("Anarchy Online - Launcher") == 2);
+    CHECK(matcher.match("The Anarchy Online") == 2);
+    CHECK(matcher.match("AO - Bob") == 3);
+    CHECK(matcher.match("xAO - Bob") == -1);
+}
+
+// The longest match wins, equal lengths go to the pattern added first
+static void test_tie_breaking() {
+    title_matcher matcher;
+    matcher.add("Bob", title_match_mode::contains, 7);
+    matcher.add("Ann", title_match_mode::contains, 3);
+    matcher.add("Ann", title_match_mode::contains, 5);
+    matcher.add("Bobby", title_match_mode::contains, 9);
+    CHECK(matcher.compile());
+
+    CHECK(matcher.match("Ann and Bob") == 7);
+    CHECK(matcher.match("Bob and Ann") == 7);
+    CHECK(matcher.match("Ann") == 3);
+    CHECK(matcher.match("Ann and Bobby") == 9);
+}
+
+static void test_regex() {
+    title_matcher matcher;
+    matcher.add("AO", title_match_mode::contains, 1);
+    matcher.add("^AO - [A-Z][a-z]+$", title_match_mode::regex, 2);
+    matcher.add("AO - Bobby", title_match_mode::exact, 3);
+    CHECK(matcher.compile());
+
+    CHECK(matcher.match("AO - Bob") == 2);
+    CHECK(matcher.match("AO - bob") == 1);
+    CHECK(matcher.match("AO - Bobby") == 2);  // Same length, the regex was added first
+    CHECK(matcher.match("nothing") == -1);
+
+    title_matcher invalid;
+    invalid.add("AO", title_match_mode::contains, 1);
+    invalid.add("([", title_match_mode::regex, 2);
+    CHECK(!invalid.compile());
+}
+
+static void test_empty_pattern() {
+    title_matcher matcher;
+    matcher.add("", title_match_mode::contains, 1);
+    matcher.add("", title_match_mode::exact, 2);
+    matcher.add("Bob", title_match_mode::contains, 3);
+    CHECK(matcher.compile());
+
+    CHECK(matcher.match("Ann") == 1);
+    CHECK(matcher.match("") == 1);
+    CHECK(matcher.match("Bob") == 3);
+
+    title_matcher exact;
+    exact.add("", title_match_mode::exact, 2);
+    CHECK(exact.compile());
+    CHECK(exact.match("") == 2);
+    CHECK(exact.match("Ann") == -1);
+}
+
+// Patterns using every byte value need 257 symbols
+static void test_full_alphabet() {
+    std::string every_byte;
+    for (int c = 0; c < 256; ++c) {
+        every_byte.push_back(static_cast<char>(c));
+    }
+    title_matcher matcher;
+    matcher.add(every_byte, title_match_mode::contains, 1);
+    matcher.add("\xff\xfe", title_match_mode::contains, 2);
+    matcher.add("\x01", title_match_mode::exact, 3);
+    CHECK(matcher.compile());
+
+    CHECK(matcher.match(every_byte) == 1);
+    CHECK(matcher.match("x\xff\xfex") == 2);
+    CHECK(matcher.match("\xff") == -1);
+    CHECK(matcher.match("\x01") == 3);
+}
+
+int main() {
+    test_overlapping_patterns();
+    test_exact_and_prefix();
+    test_tie_breaking();
+    test_regex();
+    test_empty_pattern();
+    test_full_alphabet();
+    return test_result("title_matcher_test");
+}
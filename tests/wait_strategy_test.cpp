@@ -0,0 +1,46 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "wait_strategy.h"
+#include "timing.h"
+#include "test_support.h"
+
+// Two consumers parked on one strategy, each woken by its own publish
+static void test_parked_consumers_all_wake(wait_mode mode) {
+    wait_config config;
+    config.mode = mode;
+    wait_strategy waiter(config);
+    std::atomic<bool> running{true};
+    std::atomic<bool> ready[2] = {{false}, {false}};
+    bool woken[2] = {false, false};
+    uint64_t woken_ns[2] = {0, 0};
+
+    auto consume = [&](int i) {
+        woken[i] = waiter.wait_until([&ready, i]() { return ready[i].load(); }, running,
+                                     now_ns() + 2'000'000'000);
+        woken_ns[i] = now_ns();
+    };
+    std::thread first(consume, 0);
+    std::thread second(consume, 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    for (int i = 0; i < 2; ++i) {
+        ready[i] = true;
+        waiter.notify();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    uint64_t notified_ns = now_ns();
+    first.join();
+    second.join();
+
+    CHECK(woken[0]);
+    CHECK(woken[1]);
+    CHECK(woken_ns[0] <= notified_ns);
+    CHECK(woken_ns[1] <= notified_ns);
+}
+
+int main() {
+    test_parked_consumers_all_wake(wait_mode::blocking);
+    test_parked_consumers_all_wake(wait_mode::adaptive);
+    return test_result("wait_strategy_test");
+}
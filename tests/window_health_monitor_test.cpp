@@ -0,0 +1,174 @@
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "window_health_monitor.h"
+#include "simulated_window_system.h"
+#include "timing.h"
+#include "test_support.h"
+
+// Two launched and attached clients under a monitor with short timings.
+// client0 is relaunched when lost, client1 only ever re-attaches.
+struct monitored_desktop {
+    simulated_window_system windows;
+    window_registry registry{windows};
+    title_matcher matcher;
+    std::vector<launch_spec> specs;
+    std::vector<launch_result> launched;
+
+    std::mutex mutex;
+    std::map<std::string, window_handle> current;
+    int relaunched{0};
+
+    monitored_desktop() {
+        for (int i = 0; i < 2; ++i) {
+            std::string id = "client" + std::to_string(i);
+            simulated_program program;
+            program.titles = {"Launcher", "Login", "AO - " + id};
+            program.startup_ns = 5'000'000;
+            program.step_ns = 5'000'000;
+            windows.add_program(id + ".exe", program);
+            matcher.add(id, title_match_mode::contains, i);
+            launch_spec spec;
+            spec.id = id;
+            spec.path = id + ".exe";
+            spec.window_sequence = 3;
+            specs.push_back(spec);
+        }
+        matcher.compile();
+        windows.start();
+        launched = launch_pipeline(windows, registry).run(specs);
+        windows.stop();
+        for (const auto& result : launched) {
+            registry.attach(window_key{result.spec.id, result.spec.instance}, result.window);
+            current[result.spec.id] = result.window;
+        }
+    }
+
+    health_config config() const {
+        health_config config;
+        config.sweep_interval_ms = 50;
+        config.rematch_grace_ms = 200;
+        config.relaunch_retry_ms = 1000;
+        return config;
+    }
+
+    void watch(window_health_monitor& monitor) {
+        monitor.add_client(monitored_client{specs[0], 0, true});
+        monitor.add_client(monitored_client{specs[1], 1, false});
+        monitor.set_handler([this](const monitored_client& client, window_handle window,
+                                   const launched_process& process) {
+            std::lock_guard<std::mutex> lock(mutex);
+            current[client.spec.id] = window;
+            relaunched += process.handle ? 1 : 0;
+        });
+    }
+
+    template <typename Condition>
+    bool wait_for(Condition condition) {
+        for (int i = 0; i < 300; ++i) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (condition()) {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+};
+
+static void test_relog_and_replacement() {
+    monitored_desktop desktop;
+    CHECK(desktop.launched[0].state == launch_state::ready);
+    CHECK(desktop.launched[1].state == launch_state::ready);
+    window_health_monitor monitor(desktop.windows, desktop.registry, desktop.matcher, desktop.config());
+    desktop.watch(monitor);
+    CHECK(monitor.start());
+
+    // Back to character select and in again keeps the window
+    window_handle window = desktop.launched[1].window;
+    desktop.windows.set_title(window, "Character select");
+    CHECK(desktop.wait_for([&]() { return monitor.health(1) == client_health::lost; }));
+    desktop.windows.set_title(window, "AO - client1");
+    CHECK(desktop.wait_for([&]() {
+        return monitor.health(1) == client_health::attached && monitor.reattaches() == 1;
+    }));
+
+    // A new window of the client takes over from a destroyed one
+    desktop.windows.destroy_window(window);
+    window_handle replacement = desktop.windows.create_window(4242, "AO - client1");
+    CHECK(desktop.wait_for([&]() {
+        return desktop.current["client1"] == replacement && monitor.health(1) == client_health::attached;
+    }));
+    CHECK(monitor.relaunches() == 0);
+    monitor.stop();
+}
+
+// A relog while no events were delivered is found by the sweep
+static void test_missed_retitle() {
+    monitored_desktop desktop;
+    window_health_monitor monitor(desktop.windows, desktop.registry, desktop.matcher, desktop.config());
+    desktop.watch(monitor);
+
+    window_handle window = desktop.launched[1].window;
+    desktop.windows.set_title(window, "Character select");
+    CHECK(monitor.start());
+    CHECK(desktop.wait_for([&]() { return monitor.health(1) == client_health::lost; }));
+    CHECK(monitor.health(0) == client_health::attached);
+
+    desktop.windows.set_title(window, "AO - client1");
+    CHECK(desktop.wait_for([&]() { return monitor.health(1) == client_health::attached; }));
+    CHECK(desktop.current["client1"] == window);
+    monitor.stop();
+}
+
+static void test_crash_relaunch() {
+    monitored_desktop desktop;
+    window_health_monitor monitor(desktop.windows, desktop.registry, desktop.matcher, desktop.config());
+    desktop.watch(monitor);
+    CHECK(monitor.start());
+
+    // Relaunched once the grace period passed without a matching window
+    desktop.windows.crash(desktop.launched[0].process.pid);
+    CHECK(desktop.wait_for([&]() {
+        return desktop.relaunched == 1 && monitor.health(0) == client_health::attached;
+    }));
+    CHECK(desktop.current["client0"] != desktop.launched[0].window);
+    CHECK(desktop.windows.window_title(desktop.current["client0"]) == "AO - client0");
+    CHECK(monitor.health(1) == client_health::attached);
+
+    // Without relaunch a crashed client stays lost
+    desktop.windows.crash(desktop.launched[1].process.pid);
+    CHECK(desktop.wait_for([&]() { return monitor.health(1) == client_health::lost; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    CHECK(monitor.health(1) == client_health::lost);
+    CHECK(monitor.relaunches() == 1);
+    monitor.stop();
+}
+
+static void test_relaunch_after_restart() {
+    monitored_desktop desktop;
+    window_health_monitor monitor(desktop.windows, desktop.registry, desktop.matcher, desktop.config());
+    desktop.watch(monitor);
+    CHECK(monitor.start());
+    monitor.stop();
+    CHECK(monitor.start());
+
+    desktop.windows.crash(desktop.launched[0].process.pid);
+    CHECK(desktop.wait_for([&]() {
+        return desktop.relaunched == 1 && monitor.health(0) == client_health::attached;
+    }));
+    monitor.stop();
+}
+
+int main() {
+    test_relog_and_replacement();
+    test_missed_retitle();
+    test_crash_relaunch();
+    test_relaunch_after_restart();
+    return test_result("window_health_monitor_test");
+}